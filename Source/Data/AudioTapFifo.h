@@ -0,0 +1,72 @@
+/*
+  ==============================================================================
+
+    AudioTapFifo.h
+    Created: 26 Oct 2026 9:37:02am
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Wait-free single producer / single consumer queue carrying the stereo output
+// from the end of processBlock to the analyser. The audio thread only copies the
+// block in, at most two memcpys per channel. Pushing is a no-op while nothing is
+// listening, and samples that don't fit are dropped.
+class AudioTapFifo {
+public:
+    // Consumer thread only. Samples left from before are skipped by moving the read
+    // position, which only the consumer owns, so it's safe while the audio thread pushes.
+    void setEnabled(bool shouldBeEnabled) {
+        if (shouldBeEnabled && !enabled) {
+            fifo.finishedRead(fifo.getNumReady());
+        }
+        enabled = shouldBeEnabled;
+    }
+
+    bool isEnabled() const { return enabled; }
+
+    void push(const juce::AudioBuffer<float>& buffer, int numSamples) {
+        if (!enabled || buffer.getNumChannels() == 0) {
+            return;
+        }
+        const float* left = buffer.getReadPointer(0);
+        const float* right = buffer.getReadPointer(buffer.getNumChannels() > 1 ? 1 : 0);
+
+        const auto scope = fifo.write(numSamples);
+        copyIn(left, right, 0, scope.startIndex1, scope.blockSize1);
+        copyIn(left, right, scope.blockSize1, scope.startIndex2, scope.blockSize2);
+    }
+
+    // Reads up to maxSamples of the oldest queued samples, returns how many.
+    int pop(float* left, float* right, int maxSamples) {
+        const auto scope = fifo.read(juce::jmin(maxSamples, fifo.getNumReady()));
+        copyOut(left, right, 0, scope.startIndex1, scope.blockSize1);
+        copyOut(left, right, scope.blockSize1, scope.startIndex2, scope.blockSize2);
+        return scope.blockSize1 + scope.blockSize2;
+    }
+
+    static const int capacity = 1 << 15;
+private:
+    void copyIn(const float* left, const float* right, int from, int to, int count) {
+        if (count > 0) {
+            juce::FloatVectorOperations::copy(bufferLeft.data() + to, left + from, count);
+            juce::FloatVectorOperations::copy(bufferRight.data() + to, right + from, count);
+        }
+    }
+
+    void copyOut(float* left, float* right, int to, int from, int count) const {
+        if (count > 0) {
+            juce::FloatVectorOperations::copy(left + to, bufferLeft.data() + from, count);
+            juce::FloatVectorOperations::copy(right + to, bufferRight.data() + from, count);
+        }
+    }
+
+    juce::AbstractFifo fifo { capacity };
+    std::array<float, capacity> bufferLeft;
+    std::array<float, capacity> bufferRight;
+    std::atomic<bool> enabled { false };
+};
@@ -0,0 +1,73 @@
+/*
+  ==============================================================================
+
+    CycleDetector.h
+    Created: 19 Oct 2026 9:40:12am
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+
+// Brent's cycle detection over a stream of orbit points.
+// The saved point is moved forward at every power of two, so a cycle of period p
+// is reported after at most ~2 * max(p, transient) + p points with O(1) state.
+// A return to the saved point is only a candidate until the orbit comes back to
+// it again exactly one period later: a chaotic orbit can pass close to an old
+// point once, but not twice in step.
+// The DO_LOOP macro in the fragment shader runs the same algorithm.
+class CycleDetector {
+public:
+    void reset(float x, float y) {
+        saved_x = x;
+        saved_y = y;
+        scale_sq = x * x + y * y;
+        power = 1;
+        length = 0;
+        candidate = 0;
+    }
+
+    // Feed the next orbit point. Returns the period once the orbit has come back
+    // to the saved point twice in a row, otherwise 0.
+    int push(float x, float y) {
+        ++length;
+        scale_sq = std::max(scale_sq, x * x + y * y);
+        const float dx = x - saved_x;
+        const float dy = y - saved_y;
+        if (dx * dx + dy * dy <= tolerance_sq * scale_sq) {
+            if (length == candidate) {
+                return length;
+            }
+            // Check it over the next period, from here
+            candidate = length;
+            saved_x = x;
+            saved_y = y;
+            power = length;
+            length = 0;
+            return 0;
+        }
+        if (length == power) {
+            saved_x = x;
+            saved_y = y;
+            power += power;
+            length = 0;
+        }
+        return 0;
+    }
+
+    // Relative to the largest squared radius the orbit has reached, since float
+    // rounding scales with it: a few ulps, so only cycles that repeat to within
+    // rounding count
+    static constexpr float tolerance_sq = 1e-12f;
+
+private:
+    float saved_x = 0.0f;
+    float saved_y = 0.0f;
+    float scale_sq = 0.0f;
+    int power = 1;
+    int length = 0;
+    int candidate = 0;
+};
@@ -0,0 +1,142 @@
+/*
+  ==============================================================================
+
+    FastTrig.h
+    Created: 27 Oct 2026 9:21:34am
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// Polynomial sin and cos for the map kernels. There are no branches or calls,
+// only arithmetic and selects, so a loop over lanes vectorises, and sin and cos
+// of the same argument share the reduction once inlined.
+//
+//   exact    std::sin / std::cos
+//   precise  within 2e-7 of them, reduced in double
+//   fast     within 2e-5, reduced in float
+//
+// The reduction only holds up to |x| of 6e6. The map arguments never get near
+// that, orbits escape long before.
+//
+// The argument is reduced to r in [-pi/4, pi/4] with x = r + q pi/2, then the
+// polynomials for sin r and cos r are rotated by q quarter turns.
+enum class TrigAccuracy { exact, precise, fast };
+
+namespace FastTrig {
+
+static constexpr float two_over_pi = 0.636619772367581343f;
+static constexpr double pi_over_2 = 1.57079632679489661923;
+// pi / 2 in three parts, the first two with few enough bits that q times them is exact
+static constexpr float pi_over_2_a = 1.5703125f;
+static constexpr float pi_over_2_b = 4.837512969970703125e-4f;
+static constexpr float pi_over_2_c = 7.54978995489188216e-8f;
+// Adding this rounds to a whole number and leaves it in the low mantissa bits,
+// exactly while |x| 2 / pi is below 2^22
+static constexpr float round_magic = 12582912.0f;
+
+inline std::uint32_t bits(float f) { std::uint32_t u; std::memcpy(&u, &f, 4); return u; }
+inline float fromBits(std::uint32_t u) { float f; std::memcpy(&f, &u, 4); return f; }
+
+template <TrigAccuracy accuracy>
+inline void sincos(float x, float& s, float& c) {
+    if constexpr (accuracy == TrigAccuracy::exact) {
+        s = std::sin(x);
+        c = std::cos(x);
+    }
+    else {
+        // NaN and infinity come out as NaN, as from std::sin
+        const float shifted = x * two_over_pi + round_magic;
+        const float fq = shifted - round_magic;
+        const std::uint32_t q = bits(shifted);
+
+        float r, z, ps, pc;
+        if constexpr (accuracy == TrigAccuracy::precise) {
+            r = float(double(x) - double(fq) * pi_over_2);
+            z = r * r;
+            ps = r + r * z * (-1.6666654611e-1f + z * (8.3321608736e-3f + z * -1.9515295891e-4f));
+            pc = 1.0f - 0.5f * z + z * z * (4.166664568298827e-2f + z * (-1.388731625493765e-3f + z * 2.443315711809948e-5f));
+        }
+        else {
+            r = ((x - fq * pi_over_2_a) - fq * pi_over_2_b) - fq * pi_over_2_c;
+            z = r * r;
+            ps = r * (0.9999983851f + z * (-0.1666174913f + z * 8.1365096874e-3f));
+            pc = 0.9999900350f + z * (-0.4997081404f + z * 4.0398536038e-2f);
+        }
+
+        // Odd quadrants swap sin and cos, then the signs follow the quadrant.
+        // Done on the bits so the compiler sees no branches.
+        const std::uint32_t swap = 0u - (q & 1u);
+        const std::uint32_t s0 = (bits(ps) & ~swap) | (bits(pc) & swap);
+        const std::uint32_t c0 = (bits(pc) & ~swap) | (bits(ps) & swap);
+        s = fromBits(s0 ^ ((q & 2u) << 30));
+        c = fromBits(c0 ^ (((q + 1u) & 2u) << 30));
+    }
+}
+
+template <TrigAccuracy accuracy>
+inline float sin(float x) {
+    float s, c;
+    sincos<accuracy>(x, s, c);
+    return s;
+}
+
+template <TrigAccuracy accuracy>
+inline float cos(float x) {
+    float s, c;
+    sincos<accuracy>(x, s, c);
+    return c;
+}
+
+// ph_sincos, ph_sin and ph_cos for the shaders, the same reduction and polynomials
+// as sincos above so the GPU view runs the same kernel as the audio. `precise`
+// keeps the driver from fusing the reduction steps into FMAs.
+#define PHRACTAL_GLSL_TRIG_HEAD \
+    "void ph_sincos(float x, out float s, out float c) {\n" \
+    "    float fq = roundEven(x * 0.636619772367581343);\n" \
+    "    uint q = uint(int(fq));\n"
+#define PHRACTAL_GLSL_TRIG_TAIL \
+    "    bool swap = (q & 1u) != 0u;\n" \
+    "    float s0 = swap ? pc : ps;\n" \
+    "    float c0 = swap ? ps : pc;\n" \
+    "    s = (q & 2u) != 0u ? -s0 : s0;\n" \
+    "    c = ((q + 1u) & 2u) != 0u ? -c0 : c0;\n" \
+    "}\n" \
+    "float ph_sin(float x) { float s, c; ph_sincos(x, s, c); return s; }\n" \
+    "float ph_cos(float x) { float s, c; ph_sincos(x, s, c); return c; }\n"
+
+template <TrigAccuracy accuracy>
+constexpr const char* glsl() {
+    if constexpr (accuracy == TrigAccuracy::exact) {
+        return "void ph_sincos(float x, out float s, out float c) { s = sin(x); c = cos(x); }\n"
+               "#define ph_sin sin\n"
+               "#define ph_cos cos\n";
+    }
+    else if constexpr (accuracy == TrigAccuracy::precise) {
+        return PHRACTAL_GLSL_TRIG_HEAD
+            "    precise float r = float(double(x) - double(fq) * 1.57079632679489661923LF);\n"
+            "    float z = r * r;\n"
+            "    float ps = r + r * z * (-1.6666654611e-1 + z * (8.3321608736e-3 + z * -1.9515295891e-4));\n"
+            "    float pc = 1.0 - 0.5 * z + z * z * (4.166664568298827e-2 + z * (-1.388731625493765e-3 + z * 2.443315711809948e-5));\n"
+            PHRACTAL_GLSL_TRIG_TAIL;
+    }
+    else {
+        return PHRACTAL_GLSL_TRIG_HEAD
+            "    precise float r = ((x - fq * 1.5703125) - fq * 4.837512969970703125e-4) - fq * 7.54978995489188216e-8;\n"
+            "    float z = r * r;\n"
+            "    float ps = r * (0.9999983851 + z * (-0.1666174913 + z * 8.1365096874e-3));\n"
+            "    float pc = 0.9999900350 + z * (-0.4997081404 + z * 4.0398536038e-2);\n"
+            PHRACTAL_GLSL_TRIG_TAIL;
+    }
+}
+
+#undef PHRACTAL_GLSL_TRIG_HEAD
+#undef PHRACTAL_GLSL_TRIG_TAIL
+
+}
@@ -0,0 +1,101 @@
+/*
+  ==============================================================================
+
+    FastTrigTests.cpp
+    Created: 28 Oct 2026 10:04:37am
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "FractalMaps.h"
+
+// Bounds on the FastTrig tiers: the error of sin and cos against std::sin and
+// std::cos, and how far Ikeda and Chirikov orbits drift from the exact ones over
+// a few steps. Both maps are chaotic, so any error grows exponentially along the
+// orbit; the step counts are short enough that the bounds still mean something.
+// Run by the render benchmark, category "Phractal".
+class FastTrigTests : public juce::UnitTest {
+public:
+    FastTrigTests() : juce::UnitTest("FastTrig", "Phractal") {}
+
+    void runTest() override
+    {
+        beginTest("sin and cos error");
+        expectLessThan(maxError<TrigAccuracy::precise>(), 2e-7f);
+        expectLessThan(maxError<TrigAccuracy::fast>(), 2e-5f);
+
+        beginTest("Ikeda orbit divergence over 8 steps");
+        expectLessThan(divergence(ikeda<TrigAccuracy::precise>, ikeda<TrigAccuracy::exact>, 0.9f, 0.9f), 1e-4f);
+        expectLessThan(divergence(ikeda<TrigAccuracy::fast>, ikeda<TrigAccuracy::exact>, 0.9f, 0.9f), 1e-2f);
+
+        beginTest("Chirikov orbit divergence over 8 steps");
+        expectLessThan(divergence(chirikov<TrigAccuracy::precise>, chirikov<TrigAccuracy::exact>, 1.0f, 0.5f), 2e-5f);
+        expectLessThan(divergence(chirikov<TrigAccuracy::fast>, chirikov<TrigAccuracy::exact>, 1.0f, 0.5f), 1e-3f);
+    }
+
+private:
+    static const int orbit_steps = 8;
+
+    // The map bodies of FractalMaps.h with the tier picked here instead of by the build
+    template <TrigAccuracy accuracy>
+    static void ikeda(float& x, float& y, float cx, float cy)
+    {
+        const float t = 0.4f - 6.0f / (1.0f + x * x + y * y);
+        float st, ct;
+        FastTrig::sincos<accuracy>(t, st, ct);
+        const float nx = 1.0f + cx * (x * ct - y * st);
+        const float ny = cy * (x * st + y * ct);
+        x = nx;
+        y = ny;
+    }
+
+    template <TrigAccuracy accuracy>
+    static void chirikov(float& x, float& y, float cx, float cy)
+    {
+        y += cy * FastTrig::sin<accuracy>(x);
+        x += cx * y;
+    }
+
+    // Over the range the maps reach, with extra points next to multiples of pi / 2
+    // where the quadrant changes
+    template <TrigAccuracy accuracy>
+    static float maxError()
+    {
+        float worst = 0.0f;
+        const auto check = [&worst](float x) {
+            float s, c;
+            FastTrig::sincos<accuracy>(x, s, c);
+            worst = juce::jmax(worst, std::abs(s - std::sin(x)), std::abs(c - std::cos(x)));
+        };
+        for (int i = -200000; i <= 200000; ++i) {
+            check(float(i) * 5e-4f);
+        }
+        for (int k = -64; k <= 64; ++k) {
+            const float edge = float(k * FastTrig::pi_over_2);
+            check(std::nextafter(edge, -1e9f));
+            check(edge);
+            check(std::nextafter(edge, 1e9f));
+        }
+        return worst;
+    }
+
+    template <typename Map, typename Exact>
+    static float divergence(Map map, Exact exact, float cx, float cy)
+    {
+        float worst = 0.0f;
+        for (int k = 0; k < 64; ++k) {
+            float ax = -1.0f + 0.25f * float(k % 8), ay = -1.0f + 0.25f * float(k / 8);
+            float bx = ax, by = ay;
+            for (int i = 0; i < orbit_steps; ++i) {
+                map(ax, ay, cx, cy);
+                exact(bx, by, cx, cy);
+                worst = juce::jmax(worst, std::hypot(ax - bx, ay - by));
+            }
+        }
+        return worst;
+    }
+};
+
+static FastTrigTests fastTrigTests;
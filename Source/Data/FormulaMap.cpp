@@ -0,0 +1,679 @@
+/*
+  ==============================================================================
+
+    FormulaMap.cpp
+    Created: 23 Oct 2026 10:14:36am
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#include "FormulaMap.h"
+
+#include <iomanip>
+#include <locale>
+#include <sstream>
+
+using cdouble = std::complex<double>;
+
+// Recursive descent parser building a hash-consed expression graph: identical
+// subexpressions become the same node, constant subtrees are evaluated as they
+// are built, and x * 1, x + 0 and the like collapse to x.
+class FormulaMap::Compiler {
+public:
+    explicit Compiler(const std::string& text) : s(text) {}
+
+    bool compile(FormulaMap& map, std::string& error)
+    {
+        const int root = parseExpression();
+        skipSpace();
+        if (failed.empty() && pos < s.size()) {
+            fail("Unexpected '" + std::string(1, s[pos]) + "'");
+        }
+        if (failed.empty()) {
+            generate(map, root);
+        }
+        error = failed;
+        return failed.empty();
+    }
+
+private:
+    enum Kind { constant, var_z, var_c, unary, binary };
+
+    struct Node {
+        Kind kind;
+        Op op;
+        int a, b;
+        cdouble value;
+    };
+
+    //==============================================================================
+    void fail(const std::string& message)
+    {
+        if (failed.empty()) {
+            failed = message + " at position " + std::to_string(pos + 1);
+        }
+    }
+
+    void skipSpace()
+    {
+        while (pos < s.size() && std::isspace((unsigned char)s[pos])) {
+            ++pos;
+        }
+    }
+
+    bool accept(char ch)
+    {
+        skipSpace();
+        if (pos < s.size() && s[pos] == ch) {
+            ++pos;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char ch)
+    {
+        if (!accept(ch)) {
+            fail(std::string("Expected '") + ch + "'");
+        }
+    }
+
+    int parseExpression()
+    {
+        int node = parseTerm();
+        while (failed.empty()) {
+            if (accept('+')) {
+                node = makeBinary(Op::add, node, parseTerm());
+            }
+            else if (accept('-')) {
+                node = makeBinary(Op::sub, node, parseTerm());
+            }
+            else {
+                break;
+            }
+        }
+        return node;
+    }
+
+    int parseTerm()
+    {
+        int node = parseUnary();
+        while (failed.empty()) {
+            if (accept('*')) {
+                node = makeBinary(Op::mul, node, parseUnary());
+            }
+            else if (accept('/')) {
+                node = makeBinary(Op::div, node, parseUnary());
+            }
+            else {
+                break;
+            }
+        }
+        return node;
+    }
+
+    // Every recursion of the parser goes through here: signs, exponents, and
+    // parentheses, moduli and function arguments by way of parseExpression
+    int parseUnary()
+    {
+        if (depth == max_depth) {
+            fail("The formula is nested too deeply");
+            return makeConstant(0.0);
+        }
+        ++depth;
+        int node;
+        if (accept('-')) {
+            node = makeUnary(Op::neg, parseUnary());
+        }
+        else if (accept('+')) {
+            node = parseUnary();
+        }
+        else {
+            node = parsePower();
+        }
+        --depth;
+        return node;
+    }
+
+    int parsePower()
+    {
+        const int base = parsePrimary();
+        if (!accept('^')) {
+            return base;
+        }
+        // Right associative, and binds tighter than a leading minus on the left only
+        const int exponent = parseUnary();
+        if (!failed.empty()) {
+            return base;
+        }
+        const Node& e = nodes[exponent];
+        const double n = e.value.real();
+        if (e.kind != constant || e.value.imag() != 0.0 || n != std::floor(n) || std::abs(n) > max_power) {
+            fail("Powers must be whole numbers up to " + std::to_string(max_power));
+            return base;
+        }
+        return makePower(base, int(n));
+    }
+
+    int parsePrimary()
+    {
+        skipSpace();
+        if (pos >= s.size()) {
+            fail("Unexpected end of formula");
+            return makeConstant(0.0);
+        }
+
+        const char ch = s[pos];
+        if (accept('(')) {
+            const int node = parseExpression();
+            expect(')');
+            return node;
+        }
+        if (accept('|')) {
+            const int node = parseExpression();
+            expect('|');
+            return makeUnary(Op::mag, node);
+        }
+        if (std::isdigit((unsigned char)ch) || ch == '.') {
+            // Not strtod, which reads "0,5" under a host's comma-decimal locale
+            const char* start = s.c_str() + pos;
+            juce::CharPointer_ASCII end(start);
+            const double value = juce::CharacterFunctions::readDoubleValue(end);
+            if (end.getAddress() == start) {
+                fail("Unexpected '" + std::string(1, ch) + "'");
+                return makeConstant(0.0);
+            }
+            pos += size_t(end.getAddress() - start);
+            return makeConstant(value);
+        }
+        if (std::isalpha((unsigned char)ch)) {
+            const size_t start = pos;
+            while (pos < s.size() && (std::isalnum((unsigned char)s[pos]) || s[pos] == '_')) {
+                ++pos;
+            }
+            return parseName(s.substr(start, pos - start));
+        }
+
+        fail("Unexpected '" + std::string(1, ch) + "'");
+        return makeConstant(0.0);
+    }
+
+    int parseName(const std::string& name)
+    {
+        if (name == "z") return z();
+        if (name == "c") return c();
+        if (name == "x") return makeUnary(Op::re, z());
+        if (name == "y") return makeUnary(Op::im, z());
+        if (name == "cx") return makeUnary(Op::re, c());
+        if (name == "cy") return makeUnary(Op::im, c());
+        if (name == "i") return makeConstant(cdouble(0.0, 1.0));
+        if (name == "pi") return makeConstant(juce::MathConstants<double>::pi);
+        if (name == "e") return makeConstant(std::exp(1.0));
+
+        static const std::pair<const char*, Op> functions[] = {
+            { "sin", Op::sin }, { "cos", Op::cos }, { "exp", Op::exp }, { "log", Op::log },
+            { "sqr", Op::sqr }, { "abs", Op::abs }, { "conj", Op::conj }, { "re", Op::re }, { "im", Op::im },
+        };
+        for (const auto& f : functions) {
+            if (name == f.first) {
+                expect('(');
+                const int arg = parseExpression();
+                expect(')');
+                return makeUnary(f.second, arg);
+            }
+        }
+
+        pos -= name.size();
+        fail("Unknown name '" + name + "'");
+        return makeConstant(0.0);
+    }
+
+    //==============================================================================
+    int intern(const Node& node)
+    {
+        // Also bounds the depth of visit(), which recurses over the nodes
+        if (nodes.size() >= max_nodes) {
+            fail("The formula is too long");
+            return int(nodes.size() - 1);
+        }
+        for (size_t k = 0; k < nodes.size(); ++k) {
+            const Node& n = nodes[k];
+            if (n.kind == node.kind && n.op == node.op && n.a == node.a && n.b == node.b && n.value == node.value) {
+                return int(k);
+            }
+        }
+        nodes.push_back(node);
+        return int(nodes.size() - 1);
+    }
+
+    int z() { return intern({ var_z, Op::add, -1, -1, 0.0 }); }
+    int c() { return intern({ var_c, Op::add, -1, -1, 0.0 }); }
+
+    int makeConstant(cdouble value)
+    {
+        if (!std::isfinite(value.real()) || !std::isfinite(value.imag())) {
+            fail("The constant part is not finite");
+            value = 0.0;
+        }
+        return intern({ constant, Op::add, -1, -1, value });
+    }
+
+    bool isConstant(int node, double value) const
+    {
+        return nodes[node].kind == constant && nodes[node].value == cdouble(value);
+    }
+
+    int makeUnary(Op op, int a)
+    {
+        if (nodes[a].kind == constant) {
+            return makeConstant(evaluate(op, nodes[a].value, 0.0));
+        }
+        return intern({ unary, op, a, -1, 0.0 });
+    }
+
+    int makeBinary(Op op, int a, int b)
+    {
+        if (!failed.empty()) {
+            return a;
+        }
+        if (nodes[a].kind == constant && nodes[b].kind == constant) {
+            if (op == Op::div && nodes[b].value == 0.0) {
+                fail("Division by zero");
+                return a;
+            }
+            return makeConstant(evaluate(op, nodes[a].value, nodes[b].value));
+        }
+        switch (op) {
+        case Op::add:
+            if (isConstant(a, 0.0)) return b;
+            if (isConstant(b, 0.0)) return a;
+            break;
+        case Op::sub:
+            if (isConstant(b, 0.0)) return a;
+            if (isConstant(a, 0.0)) return makeUnary(Op::neg, b);
+            break;
+        case Op::mul:
+            if (isConstant(a, 1.0)) return b;
+            if (isConstant(b, 1.0)) return a;
+            if (isConstant(a, 0.0) || isConstant(b, 0.0)) return makeConstant(0.0);
+            if (a == b) return makeUnary(Op::sqr, a);
+            break;
+        case Op::div:
+            if (isConstant(b, 1.0)) return a;
+            // Division by a constant is a multiplication by its inverse
+            if (nodes[b].kind == constant) {
+                if (nodes[b].value == 0.0) {
+                    fail("Division by zero");
+                    return a;
+                }
+                return makeBinary(Op::mul, a, makeConstant(1.0 / nodes[b].value));
+            }
+            break;
+        default:
+            break;
+        }
+        // Commutative operands in a fixed order, so a*b and b*a are the same node
+        if ((op == Op::add || op == Op::mul) && a > b) {
+            std::swap(a, b);
+        }
+        return intern({ binary, op, a, b, 0.0 });
+    }
+
+    int makePower(int base, int n)
+    {
+        if (n == 0) {
+            return makeConstant(1.0);
+        }
+        if (n < 0) {
+            return makeBinary(Op::div, makeConstant(1.0), makePower(base, -n));
+        }
+        // Square and multiply, sharing the squares
+        int result = -1;
+        int square = base;
+        for (int k = n; k > 0; k >>= 1) {
+            if (k & 1) {
+                result = (result < 0 ? square : makeBinary(Op::mul, result, square));
+            }
+            if (k > 1) {
+                square = makeUnary(Op::sqr, square);
+            }
+        }
+        return result;
+    }
+
+    //==============================================================================
+    void generate(FormulaMap& map, int root)
+    {
+        registers.assign(nodes.size(), -1);
+        map.constants.clear();
+        map.code.clear();
+
+        // Constants get their registers first, right after z and c
+        std::vector<int> order;
+        visit(root, order);
+        for (const int node : order) {
+            if (nodes[node].kind == constant) {
+                registers[node] = 2 + int(map.constants.size());
+                map.constants.push_back(std::complex<float>(nodes[node].value));
+            }
+        }
+
+        int next = 2 + int(map.constants.size());
+        for (const int node : order) {
+            const Node& n = nodes[node];
+            if (n.kind == var_z) {
+                registers[node] = 0;
+            }
+            else if (n.kind == var_c) {
+                registers[node] = 1;
+            }
+            else if (n.kind == unary || n.kind == binary) {
+                if (next >= max_registers) {
+                    fail("The formula is too long");
+                    return;
+                }
+                registers[node] = next++;
+                map.code.push_back({ n.op, juce::uint8(registers[node]), juce::uint8(registers[n.a]),
+                                     juce::uint8(n.b >= 0 ? registers[n.b] : 0) });
+            }
+        }
+        map.numRegisters = next;
+        map.result = registers[root];
+    }
+
+    // Children before parents
+    void visit(int node, std::vector<int>& order)
+    {
+        if (std::find(order.begin(), order.end(), node) != order.end()) {
+            return;
+        }
+        if (nodes[node].a >= 0) {
+            visit(nodes[node].a, order);
+        }
+        if (nodes[node].b >= 0) {
+            visit(nodes[node].b, order);
+        }
+        order.push_back(node);
+    }
+
+    static cdouble evaluate(Op op, cdouble a, cdouble b)
+    {
+        switch (op) {
+        case Op::add:  return a + b;
+        case Op::sub:  return a - b;
+        case Op::mul:  return a * b;
+        case Op::div:  return a / b;
+        case Op::neg:  return -a;
+        case Op::sqr:  return a * a;
+        case Op::sin:  return std::sin(a);
+        case Op::cos:  return std::cos(a);
+        case Op::exp:  return std::exp(a);
+        case Op::log:  return std::log(a);
+        case Op::abs:  return { std::abs(a.real()), std::abs(a.imag()) };
+        case Op::conj: return std::conj(a);
+        case Op::re:   return a.real();
+        case Op::im:   return a.imag();
+        case Op::mag:  return std::abs(a);
+        }
+        return 0.0;
+    }
+
+    // Far more than any formula uses, and shallow enough for the message thread's stack
+    static const int max_depth = 64;
+    static const size_t max_nodes = 1024;
+
+    const std::string s;
+    size_t pos = 0;
+    int depth = 0;
+    std::string failed;
+    std::vector<Node> nodes;
+    std::vector<int> registers;
+};
+
+static std::atomic<int> next_formula_id { 32 };
+
+std::shared_ptr<const FormulaMap> FormulaMap::compile(const juce::String& text, juce::String& error)
+{
+    auto map = std::make_shared<FormulaMap>();
+    Compiler compiler(text.toStdString());
+    std::string message;
+    if (!compiler.compile(*map, message)) {
+        error = juce::String(message);
+        return nullptr;
+    }
+
+    map->source = text;
+    map->id = next_formula_id++;
+    map->emitGlsl();
+    error = juce::String();
+    return map;
+}
+
+void FormulaMap::run(float* x, float* y, const float* cx, const float* cy, int lanes) const
+{
+    if (lanes == 1) {
+        runOne(*x, *y, *cx, *cy);
+        return;
+    }
+
+    float re[max_registers][max_lanes];
+    float im[max_registers][max_lanes];
+
+    for (int first = 0; first < lanes; first += max_lanes) {
+        const int n = std::min(max_lanes, lanes - first);
+
+        for (int l = 0; l < n; ++l) {
+            re[0][l] = x[first + l];
+            im[0][l] = y[first + l];
+            re[1][l] = cx[first + l];
+            im[1][l] = cy[first + l];
+        }
+        for (size_t k = 0; k < constants.size(); ++k) {
+            for (int l = 0; l < n; ++l) {
+                re[2 + k][l] = constants[k].real();
+                im[2 + k][l] = constants[k].imag();
+            }
+        }
+
+        for (const auto& ins : code) {
+            float* dr = re[ins.dst];
+            float* di = im[ins.dst];
+            const float* ar = re[ins.a];
+            const float* ai = im[ins.a];
+            const float* br = re[ins.b];
+            const float* bi = im[ins.b];
+
+            switch (ins.op) {
+            case Op::add:
+                for (int l = 0; l < n; ++l) { dr[l] = ar[l] + br[l]; di[l] = ai[l] + bi[l]; }
+                break;
+            case Op::sub:
+                for (int l = 0; l < n; ++l) { dr[l] = ar[l] - br[l]; di[l] = ai[l] - bi[l]; }
+                break;
+            case Op::mul:
+                for (int l = 0; l < n; ++l) {
+                    const float r = ar[l] * br[l] - ai[l] * bi[l];
+                    di[l] = ar[l] * bi[l] + ai[l] * br[l];
+                    dr[l] = r;
+                }
+                break;
+            case Op::div:
+                for (int l = 0; l < n; ++l) {
+                    const float inv = 1.0f / (br[l] * br[l] + bi[l] * bi[l]);
+                    const float r = (ar[l] * br[l] + ai[l] * bi[l]) * inv;
+                    di[l] = (ai[l] * br[l] - ar[l] * bi[l]) * inv;
+                    dr[l] = r;
+                }
+                break;
+            case Op::neg:
+                for (int l = 0; l < n; ++l) { dr[l] = -ar[l]; di[l] = -ai[l]; }
+                break;
+            case Op::sqr:
+                for (int l = 0; l < n; ++l) {
+                    const float r = ar[l] * ar[l] - ai[l] * ai[l];
+                    di[l] = 2.0f * ar[l] * ai[l];
+                    dr[l] = r;
+                }
+                break;
+            case Op::sin:
+                for (int l = 0; l < n; ++l) {
+                    const float r = ph_sin(ar[l]) * std::cosh(ai[l]);
+                    di[l] = ph_cos(ar[l]) * std::sinh(ai[l]);
+                    dr[l] = r;
+                }
+                break;
+            case Op::cos:
+                for (int l = 0; l < n; ++l) {
+                    const float r = ph_cos(ar[l]) * std::cosh(ai[l]);
+                    di[l] = -ph_sin(ar[l]) * std::sinh(ai[l]);
+                    dr[l] = r;
+                }
+                break;
+            case Op::exp:
+                for (int l = 0; l < n; ++l) {
+                    const float m = std::exp(ar[l]);
+                    dr[l] = m * ph_cos(ai[l]);
+                    di[l] = m * ph_sin(ai[l]);
+                }
+                break;
+            case Op::log:
+                for (int l = 0; l < n; ++l) {
+                    const float r = 0.5f * std::log(ar[l] * ar[l] + ai[l] * ai[l]);
+                    di[l] = std::atan2(ai[l], ar[l]);
+                    dr[l] = r;
+                }
+                break;
+            case Op::abs:
+                for (int l = 0; l < n; ++l) { dr[l] = std::abs(ar[l]); di[l] = std::abs(ai[l]); }
+                break;
+            case Op::conj:
+                for (int l = 0; l < n; ++l) { dr[l] = ar[l]; di[l] = -ai[l]; }
+                break;
+            case Op::re:
+                for (int l = 0; l < n; ++l) { dr[l] = ar[l]; di[l] = 0.0f; }
+                break;
+            case Op::im:
+                for (int l = 0; l < n; ++l) { dr[l] = ai[l]; di[l] = 0.0f; }
+                break;
+            case Op::mag:
+                for (int l = 0; l < n; ++l) { dr[l] = std::sqrt(ar[l] * ar[l] + ai[l] * ai[l]); di[l] = 0.0f; }
+                break;
+            }
+        }
+
+        for (int l = 0; l < n; ++l) {
+            x[first + l] = re[result][l];
+            y[first + l] = im[result][l];
+        }
+    }
+}
+
+// The audio path plays one orbit at a time, so it gets its own copy of the
+// interpreter without the lane loops
+void FormulaMap::runOne(float& x, float& y, float cx, float cy) const
+{
+    float re[max_registers];
+    float im[max_registers];
+    re[0] = x;
+    im[0] = y;
+    re[1] = cx;
+    im[1] = cy;
+    for (size_t k = 0; k < constants.size(); ++k) {
+        re[2 + k] = constants[k].real();
+        im[2 + k] = constants[k].imag();
+    }
+
+    for (const auto& ins : code) {
+        const float ar = re[ins.a];
+        const float ai = im[ins.a];
+        const float br = re[ins.b];
+        const float bi = im[ins.b];
+        float r = 0.0f, i = 0.0f;
+
+        switch (ins.op) {
+        case Op::add:  r = ar + br; i = ai + bi; break;
+        case Op::sub:  r = ar - br; i = ai - bi; break;
+        case Op::mul:  r = ar * br - ai * bi; i = ar * bi + ai * br; break;
+        case Op::div: {
+            const float inv = 1.0f / (br * br + bi * bi);
+            r = (ar * br + ai * bi) * inv;
+            i = (ai * br - ar * bi) * inv;
+            break;
+        }
+        case Op::neg:  r = -ar; i = -ai; break;
+        case Op::sqr:  r = ar * ar - ai * ai; i = 2.0f * ar * ai; break;
+        case Op::sin:  r = ph_sin(ar) * std::cosh(ai); i = ph_cos(ar) * std::sinh(ai); break;
+        case Op::cos:  r = ph_cos(ar) * std::cosh(ai); i = -ph_sin(ar) * std::sinh(ai); break;
+        case Op::exp: {
+            const float m = std::exp(ar);
+            r = m * ph_cos(ai);
+            i = m * ph_sin(ai);
+            break;
+        }
+        case Op::log:  r = 0.5f * std::log(ar * ar + ai * ai); i = std::atan2(ai, ar); break;
+        case Op::abs:  r = std::abs(ar); i = std::abs(ai); break;
+        case Op::conj: r = ar; i = -ai; break;
+        case Op::re:   r = ar; break;
+        case Op::im:   r = ai; break;
+        case Op::mag:  r = std::sqrt(ar * ar + ai * ai); break;
+        }
+        re[ins.dst] = r;
+        im[ins.dst] = i;
+    }
+
+    x = re[result];
+    y = im[result];
+}
+
+static juce::String glslFloat(float v)
+{
+    // As "%.9g", but always with a decimal point whatever the host's locale
+    std::ostringstream text;
+    text.imbue(std::locale::classic());
+    text << std::setprecision(9) << double(v);
+    juce::String s(text.str());
+    if (!s.containsAnyOf(".e")) {
+        s << ".0";
+    }
+    return s;
+}
+
+void FormulaMap::emitGlsl()
+{
+    const auto reg = [](int r) { return "r" + juce::String(r); };
+
+    glsl = "VEC2 custom(VEC2 z, VEC2 c) {\n"
+           "    VEC2 r0 = z;\n"
+           "    VEC2 r1 = c;\n";
+    for (size_t k = 0; k < constants.size(); ++k) {
+        glsl << "    VEC2 " << reg(2 + int(k)) << " = VEC2(" << glslFloat(constants[k].real()) << ", " << glslFloat(constants[k].imag()) << ");\n";
+    }
+
+    for (const auto& ins : code) {
+        const auto a = reg(ins.a);
+        const auto b = reg(ins.b);
+        juce::String value;
+        switch (ins.op) {
+        case Op::add:  value = a + " + " + b; break;
+        case Op::sub:  value = a + " - " + b; break;
+        case Op::mul:  value = "cx_mul(" + a + ", " + b + ")"; break;
+        case Op::div:  value = "cx_div(" + a + ", " + b + ")"; break;
+        case Op::neg:  value = "-" + a; break;
+        case Op::sqr:  value = "cx_sqr(" + a + ")"; break;
+        case Op::sin:  value = "cx_sin(" + a + ")"; break;
+        case Op::cos:  value = "cx_cos(" + a + ")"; break;
+        case Op::exp:  value = "cx_exp(" + a + ")"; break;
+        case Op::log:  value = "VEC2(0.5 * log(dot(" + a + ", " + a + ")), atan(" + a + ".y, " + a + ".x))"; break;
+        case Op::abs:  value = "abs(" + a + ")"; break;
+        case Op::conj: value = "VEC2(" + a + ".x, -" + a + ".y)"; break;
+        case Op::re:   value = "VEC2(" + a + ".x, 0.0)"; break;
+        case Op::im:   value = "VEC2(" + a + ".y, 0.0)"; break;
+        case Op::mag:  value = "VEC2(length(" + a + "), 0.0)"; break;
+        }
+        glsl << "    VEC2 " << reg(ins.dst) << " = " << value << ";\n";
+    }
+
+    glsl << "    return " << reg(result) << ";\n"
+         << "}\n";
+}
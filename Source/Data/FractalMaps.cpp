@@ -0,0 +1,23 @@
+/*
+  ==============================================================================
+
+    FractalMaps.cpp
+    Created: 19 Oct 2026 9:12:40am
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#include "FractalMaps.h"
+
+bool mandelbrot_interior(float cx, float cy) {
+    // Main cardioid
+    float qx = cx - 0.25f;
+    float q = qx * qx + cy * cy;
+    if (q * (q + qx) <= 0.25f * cy * cy) {
+        return true;
+    }
+    // Period-2 bulb
+    float bx = cx + 1.0f;
+    return bx * bx + cy * cy <= 0.0625f;
+}
@@ -0,0 +1,187 @@
+/*
+  ==============================================================================
+
+    FractalMaps.h
+    Created: 19 Oct 2026 9:12:40am
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cmath>
+#include <complex>
+#include "FastTrig.h"
+
+static const int sample_rate = 48000;
+static const int max_freq = 4000;
+static const int max_iters = 1200;
+static const double escape_radius_sq = 1000.0;
+
+// Every map is defined once, as a body that is valid both as C++ and as GLSL.
+// It updates x and y in place from the constant cx, cy, declares its temporaries
+// with T and spells constants as T(...), and only calls the ph_ helpers. C++ gets
+// an inline kernel templated on T, the fragment shader gets the same body with
+// T as FLOAT (see fractal_glsl_maps), so the audio, offline and GPU renders all
+// iterate exactly the same arithmetic.
+//
+// X(name, label, has_distance_estimate): the GLSL name and the name of the C++
+// kernel, the name shown in the UI, and whether the shader has d_<name>.
+#define PHRACTAL_FRACTALS(X) \
+    X(mandelbrot,   "Mandelbrot",   true)  \
+    X(burning_ship, "Burning ship", true)  \
+    X(feather,      "Feather",      true)  \
+    X(sfx,          "SFX",          false) \
+    X(henon,        "Henon",        false) \
+    X(duffing,      "Duffing",      false) \
+    X(ikeda,        "Ikeda",        false) \
+    X(chirikov,     "Chirikov",     false)
+
+#define PHRACTAL_MAP_mandelbrot \
+    T nx = x * x - y * y + cx; \
+    T ny = T(2.0) * x * y + cy; \
+    x = nx; \
+    y = ny;
+
+#define PHRACTAL_MAP_burning_ship \
+    T nx = x * x - y * y + cx; \
+    T ny = T(2.0) * ph_abs(x * y) + cy; \
+    x = nx; \
+    y = ny;
+
+// z^3 / (1 + (x^2, y^2)) + c
+#define PHRACTAL_MAP_feather \
+    T x2 = x * x; \
+    T y2 = y * y; \
+    T ax = x * (x2 - T(3.0) * y2); \
+    T ay = y * (T(3.0) * x2 - y2); \
+    T bx = T(1.0) + x2; \
+    T inv = T(1.0) / (bx * bx + y2 * y2); \
+    T nx = (ax * bx + ay * y2) * inv + cx; \
+    T ny = (ay * bx - ax * y2) * inv + cy; \
+    x = nx; \
+    y = ny;
+
+// z |z|^2 - z (cx^2, cy^2)
+#define PHRACTAL_MAP_sfx \
+    T r2 = x * x + y * y; \
+    T cx2 = cx * cx; \
+    T cy2 = cy * cy; \
+    T nx = x * r2 - (x * cx2 - y * cy2); \
+    T ny = y * r2 - (x * cy2 + y * cx2); \
+    x = nx; \
+    y = ny;
+
+#define PHRACTAL_MAP_henon \
+    T nx = T(1.0) - cx * x * x + y; \
+    T ny = cy * x; \
+    x = nx; \
+    y = ny;
+
+#define PHRACTAL_MAP_duffing \
+    T nx = y; \
+    T ny = -cy * x + cx * y - y * y * y; \
+    x = nx; \
+    y = ny;
+
+#define PHRACTAL_MAP_ikeda \
+    T t = T(0.4) - T(6.0) / (T(1.0) + x * x + y * y); \
+    T st = ph_sin(t); \
+    T ct = ph_cos(t); \
+    T nx = T(1.0) + cx * (x * ct - y * st); \
+    T ny = cy * (x * st + y * ct); \
+    x = nx; \
+    y = ny;
+
+#define PHRACTAL_MAP_chirikov \
+    y += cy * ph_sin(x); \
+    x += cx * y;
+
+// Accuracy of sin and cos in the float kernels (see FastTrig.h). Ikeda and
+// Chirikov spend most of their time in them, the polynomials let them vectorise.
+// Fixed at build time, the kernels are inlined with it; the shaders get the same
+// tier from fractal_glsl_trig.
+#ifndef PHRACTAL_TRIG_ACCURACY
+ #define PHRACTAL_TRIG_ACCURACY precise
+#endif
+static constexpr TrigAccuracy map_trig_accuracy = TrigAccuracy::PHRACTAL_TRIG_ACCURACY;
+inline constexpr const char* fractal_glsl_trig = FastTrig::glsl<map_trig_accuracy>();
+
+// Helpers the map bodies may use; the shader maps ph_abs onto the GLSL built-in
+// and gets ph_sin and ph_cos from fractal_glsl_trig
+template <typename T> inline T ph_abs(T v) { using std::abs; return abs(v); }
+template <typename T> inline T ph_sin(T v) { using std::sin; return sin(v); }
+template <typename T> inline T ph_cos(T v) { using std::cos; return cos(v); }
+inline float ph_sin(float v) { return FastTrig::sin<map_trig_accuracy>(v); }
+inline float ph_cos(float v) { return FastTrig::cos<map_trig_accuracy>(v); }
+
+// Inline kernels, e.g. mandelbrot<float>(x, y, cx, cy). Any T with the arithmetic
+// operators and ph_ overloads works, a SIMD type runs one orbit per lane.
+#define PHRACTAL_KERNEL(name, label, de) \
+    template <typename T> inline void name(T& x, T& y, T cx, T cy) { PHRACTAL_MAP_##name } \
+    struct name##_kernel { \
+        template <typename T> void operator()(T& x, T& y, T cx, T cy) const { name<T>(x, y, cx, cy); } \
+    };
+PHRACTAL_FRACTALS(PHRACTAL_KERNEL)
+#undef PHRACTAL_KERNEL
+
+#define PHRACTAL_ENUM(name, label, de) fractal_##name,
+enum FractalType { PHRACTAL_FRACTALS(PHRACTAL_ENUM) num_fractals };
+#undef PHRACTAL_ENUM
+
+// Calls visitor with the kernel object of the given type, so a loop written
+// inside the visitor is compiled once per map with the map inlined, instead of
+// calling through a pointer every iteration.
+template <typename Visitor>
+inline void visitFractal(int type, Visitor&& visitor) {
+    switch (type) {
+    #define PHRACTAL_CASE(name, label, de) case fractal_##name: visitor(name##_kernel{}); break;
+    PHRACTAL_FRACTALS(PHRACTAL_CASE)
+    #undef PHRACTAL_CASE
+    default: break;
+    }
+}
+
+// Pointer table for the places that aren't hot enough to specialise
+typedef void (*Fractal)(float&, float&, float, float);
+
+#define PHRACTAL_POINTER(name, label, de) &name<float>,
+inline constexpr Fractal all_fractals[] = { PHRACTAL_FRACTALS(PHRACTAL_POINTER) };
+#undef PHRACTAL_POINTER
+
+#define PHRACTAL_NAME(name, label, de) #name,
+inline constexpr const char* fractal_names[] = { PHRACTAL_FRACTALS(PHRACTAL_NAME) };
+#undef PHRACTAL_NAME
+
+#define PHRACTAL_LABEL(name, label, de) label,
+inline constexpr const char* fractal_labels[] = { PHRACTAL_FRACTALS(PHRACTAL_LABEL) };
+#undef PHRACTAL_LABEL
+
+#define PHRACTAL_HAS_DE(name, label, de) de,
+inline constexpr bool fractal_has_distance_estimate[] = { PHRACTAL_FRACTALS(PHRACTAL_HAS_DE) };
+#undef PHRACTAL_HAS_DE
+
+// GLSL for every map, VEC2 name(VEC2 z, VEC2 c), generated from the same bodies.
+// Needs FLOAT and VEC2 defined and fractal_glsl_trig before it.
+#define PHRACTAL_STRINGIFY_BODY(...) #__VA_ARGS__
+#define PHRACTAL_STRINGIFY(...) PHRACTAL_STRINGIFY_BODY(__VA_ARGS__)
+#define PHRACTAL_GLSL(name, label, de) \
+    "VEC2 " #name "(VEC2 z, VEC2 c) {\n" \
+    "    FLOAT x = z.x; FLOAT y = z.y; FLOAT cx = c.x; FLOAT cy = c.y;\n" \
+    "    " PHRACTAL_STRINGIFY(PHRACTAL_MAP_##name) "\n" \
+    "    return VEC2(x, y);\n" \
+    "}\n"
+inline constexpr char fractal_glsl_maps[] =
+    "#define T FLOAT\n"
+    "#define ph_abs abs\n"
+    PHRACTAL_FRACTALS(PHRACTAL_GLSL)
+    "#undef T\n";
+#undef PHRACTAL_GLSL
+
+// True if c lies in the main cardioid or the period-2 bulb of the Mandelbrot
+// set, i.e. the orbit of c is known to stay bounded without iterating it.
+// Mirrored by in_cardioid_or_bulb() in the fragment shader. The voices don't use
+// it: it says the orbit stays bounded, not when it settles, and they play the
+// transient until CycleDetector finds the cycle.
+bool mandelbrot_interior(float cx, float cy);
@@ -0,0 +1,286 @@
+/*
+  ==============================================================================
+
+    GrainEngine.cpp
+    Created: 27 Oct 2026 2:37:19pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#include "GrainEngine.h"
+
+// One step of the map for every grain, in place
+static void step(const FormulaMap& map, float* x, float* y, const float* cx, const float* cy, int count) {
+    map.run(x, y, cx, cy, count);
+}
+
+template <typename Map>
+static void step(const Map& map, float* x, float* y, const float* cx, const float* cy, int count) {
+    for (int g = 0; g < count; ++g) {
+        map(x[g], y[g], cx[g], cy[g]);
+    }
+}
+
+GrainEngine::GrainEngine() {
+    for (auto* v : { &grain_cx, &grain_cy, &centre_x, &centre_y, &cur_x, &cur_y, &next_x, &next_y,
+                     &phase, &inc, &gain_l, &gain_r, &step_x, &step_y }) {
+        v->resize(max_grains);
+    }
+    age.resize(max_grains);
+    length.resize(max_grains);
+    delay.resize(max_grains);
+    points_x.resize(size_t(max_grains) * points_per_grain);
+    points_y.resize(size_t(max_grains) * points_per_grain);
+
+    for (int i = 0; i <= window_size; ++i) {
+        window[i] = 0.5f - 0.5f * std::cos(juce::MathConstants<float>::twoPi * float(i) / float(window_size));
+    }
+}
+
+void GrainEngine::prepareToPlay(double newSampleRate) {
+    sampleRate = newSampleRate;
+    reset();
+}
+
+void GrainEngine::setFractal(int type) {
+    if (type == fractalType) {
+        return;
+    }
+    jassert(type >= 0 && type <= FormulaMap::custom_fractal);
+    fractalType = type;
+    // Orbits of the old map mean nothing under the new one
+    numActive = 0;
+}
+
+void GrainEngine::setFormula(std::shared_ptr<const FormulaMap> map) {
+    if (map == formula) {
+        return;
+    }
+    // The old formula is still owned by the processor, so this never frees it
+    formula = std::move(map);
+    if (fractalType == FormulaMap::custom_fractal) {
+        numActive = 0;
+    }
+}
+
+void GrainEngine::setRegion(float x0, float y0, float x1, float y1) {
+    region_x0 = juce::jmin(x0, x1);
+    region_y0 = juce::jmin(y0, y1);
+    region_x1 = juce::jmax(x0, x1);
+    region_y1 = juce::jmax(y0, y1);
+}
+
+void GrainEngine::setConstant(float cx, float cy, bool followsStart) {
+    const_x = cx;
+    const_y = cy;
+    constantFollowsStart = followsStart;
+}
+
+void GrainEngine::setPitch(double ratio) {
+    pitch = ratio;
+}
+
+void GrainEngine::setShape(float sizeSeconds, float grainsPerSecond, float pitchJitterSemitones, float spread) {
+    grainLength = juce::jmax(16, juce::roundToInt(sizeSeconds * sampleRate));
+    meanInterval = sampleRate / juce::jmax(1.0f, grainsPerSecond);
+    pitchJitter = pitchJitterSemitones;
+    panSpread = spread;
+
+    // Overlapping grains are uncorrelated, so their level adds up as a power sum
+    amplitude = 1.0f / std::sqrt(juce::jmax(1.0f, float(grainLength / meanInterval)));
+}
+
+void GrainEngine::reset() {
+    numActive = 0;
+    untilNextGrain = 0.0;
+}
+
+void GrainEngine::getNextAudioBlock(juce::AudioBuffer<float>& buffer, int startSample, int numSamples) {
+    auto* left = buffer.getWritePointer(0, startSample);
+    auto* right = buffer.getWritePointer(buffer.getNumChannels() > 1 ? 1 : 0, startSample);
+    juce::FloatVectorOperations::clear(left, numSamples);
+    juce::FloatVectorOperations::clear(right, numSamples);
+
+    if (fractalType == FormulaMap::custom_fractal && formula == nullptr) {
+        numActive = 0;
+        return;
+    }
+
+    for (int pos = 0; pos < numSamples; pos += chunk_size) {
+        renderChunk(left + pos, right + pos, juce::jmin(chunk_size, numSamples - pos));
+    }
+}
+
+void GrainEngine::renderChunk(float* left, float* right, int numSamples) {
+    // Grains starting inside this chunk, each at its own sample
+    while (untilNextGrain < numSamples) {
+        spawn(juce::jmax(0, int(untilNextGrain)));
+        untilNextGrain += meanInterval * (0.5 + random.nextDouble());
+    }
+    untilNextGrain -= numSamples;
+
+    if (numActive == 0) {
+        return;
+    }
+
+    // Points the slowest-to-finish grain needs, one spare for rounding in the phase sums
+    int numPoints = 2;
+    for (int g = 0; g < numActive; ++g) {
+        const int steps = int(phase[g] + inc[g] * float(numSamples - delay[g]));
+        numPoints = juce::jmax(numPoints, steps + 3);
+    }
+    numPoints = juce::jmin(numPoints, points_per_grain);
+
+    visitMap(fractalType, formula.get(), [&](const auto& map) {
+        iterate(map, numPoints);
+    });
+
+    const float windowScale = float(window_size);
+    for (int g = 0; g < numActive; ++g) {
+        const float* px = points_x.data() + size_t(g) * points_per_grain;
+        const float* py = points_y.data() + size_t(g) * points_per_grain;
+        const float cx = centre_x[g];
+        const float cy = centre_y[g];
+        const float in = inc[g];
+        const float gl = gain_l[g];
+        const float gr = gain_r[g];
+        const int len = length[g];
+        const float ageToWindow = windowScale / float(len);
+        const int end = juce::jmin(numSamples, delay[g] + len - age[g]);
+
+        float ph = phase[g];
+        int k = 0;
+        int a = age[g];
+        for (int i = delay[g]; i < end; ++i, ++a) {
+            float dx = px[k] + (px[k + 1] - px[k]) * ph - cx;
+            float dy = py[k] + (py[k + 1] - py[k]) * ph - cy;
+
+            // Same clamp as the orbit engine, escaping grains don't blow up the mix
+            const float m = dx * dx + dy * dy;
+            if (m > 2.0f) {
+                dx *= 2.0f / m;
+                dy *= 2.0f / m;
+            }
+
+            const float env = window[size_t(float(a) * ageToWindow)];
+            left[i] += dx * env * gl;
+            right[i] += dy * env * gr;
+
+            ph += in;
+            if (ph >= 1.0f && k + 2 < points_per_grain) {
+                ph -= 1.0f;
+                ++k;
+            }
+        }
+
+        age[g] = a;
+        delay[g] = 0;
+        phase[g] = ph;
+        cur_x[g] = px[k];
+        cur_y[g] = py[k];
+        next_x[g] = px[k + 1];
+        next_y[g] = py[k + 1];
+    }
+
+    // Backwards, so the grain moved into a freed slot has been seen already
+    for (int g = numActive; --g >= 0;) {
+        if (age[g] >= length[g]) {
+            release(g);
+        }
+    }
+}
+
+template <typename Map>
+void GrainEngine::iterate(const Map& map, int numPoints) {
+    for (int g = 0; g < numActive; ++g) {
+        float* px = points_x.data() + size_t(g) * points_per_grain;
+        float* py = points_y.data() + size_t(g) * points_per_grain;
+        px[0] = cur_x[g];
+        py[0] = cur_y[g];
+        px[1] = next_x[g];
+        py[1] = next_y[g];
+        step_x[g] = next_x[g];
+        step_y[g] = next_y[g];
+    }
+
+    const float escape = float(escape_radius_sq);
+    for (int k = 2; k < numPoints; ++k) {
+        step(map, step_x.data(), step_y.data(), grain_cx.data(), grain_cy.data(), numActive);
+
+        // An escaping grain holds its last point, which the DC blocker takes out, so
+        // it fades with its window instead of clicking. Holding is sticky: the held
+        // point escapes again on every later step.
+        for (int g = 0; g < numActive; ++g) {
+            const size_t at = size_t(g) * points_per_grain + k;
+            const float r = step_x[g] * step_x[g] + step_y[g] * step_y[g];
+            const bool ok = (r <= escape);
+            step_x[g] = ok ? step_x[g] : points_x[at - 1];
+            step_y[g] = ok ? step_y[g] : points_y[at - 1];
+            points_x[at] = step_x[g];
+            points_y[at] = step_y[g];
+        }
+    }
+}
+
+void GrainEngine::spawn(int startDelay) {
+    if (numActive == max_grains) {
+        return;
+    }
+    const int g = numActive++;
+
+    const float x = region_x0 + random.nextFloat() * (region_x1 - region_x0);
+    const float y = region_y0 + random.nextFloat() * (region_y1 - region_y0);
+    centre_x[g] = x;
+    centre_y[g] = y;
+    grain_cx[g] = constantFollowsStart ? x : const_x;
+    grain_cy[g] = constantFollowsStart ? y : const_y;
+
+    cur_x[g] = x;
+    cur_y[g] = y;
+    float nx = x, ny = y;
+    visitMap(fractalType, formula.get(), [&](const auto& map) {
+        map(nx, ny, grain_cx[g], grain_cy[g]);
+    });
+    if (!(nx * nx + ny * ny <= float(escape_radius_sq))) {
+        // Escapes straight away, it would only be silence
+        --numActive;
+        return;
+    }
+    next_x[g] = nx;
+    next_y[g] = ny;
+
+    const float detune = pitchJitter * (2.0f * random.nextFloat() - 1.0f);
+    inc[g] = float(juce::jmin(1.0, pitch * max_freq / sampleRate * std::pow(2.0, detune / 12.0)));
+    phase[g] = 0.0f;
+
+    const float pan = panSpread * (2.0f * random.nextFloat() - 1.0f);
+    gain_l[g] = amplitude * juce::jmin(1.0f, 1.0f - pan);
+    gain_r[g] = amplitude * juce::jmin(1.0f, 1.0f + pan);
+
+    age[g] = 0;
+    length[g] = grainLength;
+    delay[g] = startDelay;
+}
+
+void GrainEngine::release(int grain) {
+    const int last = --numActive;
+    if (grain == last) {
+        return;
+    }
+    grain_cx[grain] = grain_cx[last];
+    grain_cy[grain] = grain_cy[last];
+    centre_x[grain] = centre_x[last];
+    centre_y[grain] = centre_y[last];
+    cur_x[grain] = cur_x[last];
+    cur_y[grain] = cur_y[last];
+    next_x[grain] = next_x[last];
+    next_y[grain] = next_y[last];
+    phase[grain] = phase[last];
+    inc[grain] = inc[last];
+    gain_l[grain] = gain_l[last];
+    gain_r[grain] = gain_r[last];
+    age[grain] = age[last];
+    length[grain] = length[last];
+    delay[grain] = delay[last];
+}
@@ -0,0 +1,100 @@
+/*
+  ==============================================================================
+
+    GrainEngine.h
+    Created: 27 Oct 2026 2:37:19pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FractalMaps.h"
+#include "FormulaMap.h"
+
+// Granular engine played by a voice instead of its single orbit. Grains are short
+// Hann-windowed orbits, each started from a random point in a region of the
+// plane, with its own pitch and pan. They are spawned at sample positions drawn
+// around the density, taken from a fixed pool of max_grains, and dropped when
+// the pool is full.
+//
+// Work is done in chunks of up to chunk_size samples. First every live grain's
+// orbit is advanced as far as the chunk needs in one pass over the whole pool,
+// the map running across the grains held in separate arrays (SoA) so the loop
+// vectorises. Then each grain's points are interpolated, windowed and panned
+// into the output.
+class GrainEngine {
+public:
+    GrainEngine();
+
+    void prepareToPlay(double sampleRate);
+    void setFractal(int type);
+    // Map played while the type is FormulaMap::custom_fractal. Null plays silence.
+    void setFormula(std::shared_ptr<const FormulaMap> map);
+    // Grains start anywhere in the rectangle from (x0, y0) to (x1, y1)
+    void setRegion(float x0, float y0, float x1, float y1);
+    // When c follows the start, every grain gets its own start point as c
+    void setConstant(float cx, float cy, bool followsStart);
+    // Orbit points per second relative to max_freq
+    void setPitch(double ratio);
+    void setShape(float sizeSeconds, float grainsPerSecond, float pitchJitterSemitones, float spread);
+    // Drops every grain, the next one starts on the first sample
+    void reset();
+
+    // Replaces numSamples of buffer from startSample
+    void getNextAudioBlock(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    int getNumActive() const { return numActive; }
+
+    static const int max_grains = 512;
+    static const int chunk_size = 64;
+    static const int window_size = 1024;
+private:
+    void renderChunk(float* left, float* right, int numSamples);
+    void spawn(int delay);
+    template <typename Map> void iterate(const Map& map, int numPoints);
+    void release(int grain);
+
+    // Points held per grain for a chunk: the current and next ones, then at most
+    // one more per sample, grains never step faster than that
+    static const int points_per_grain = chunk_size + 2;
+
+    int fractalType = 0;
+    std::shared_ptr<const FormulaMap> formula;
+
+    double sampleRate = sample_rate;
+    double pitch = 1.0;
+    float region_x0 = 0.0f, region_y0 = 0.0f;
+    float region_x1 = 0.0f, region_y1 = 0.0f;
+    float const_x = 0.0f, const_y = 0.0f;
+    bool constantFollowsStart = true;
+    int grainLength = 2880;
+    double meanInterval = 240.0;
+    float pitchJitter = 0.0f;
+    float panSpread = 0.5f;
+    float amplitude = 1.0f;
+
+    // Samples until the next grain starts, from the start of the next chunk
+    double untilNextGrain = 0.0;
+    juce::Random random;
+
+    // Live grains are packed at the front of every array
+    int numActive = 0;
+    std::vector<float> grain_cx, grain_cy;
+    std::vector<float> centre_x, centre_y;    // Where the grain started, the zero of its signal
+    std::vector<float> cur_x, cur_y;          // The point being left
+    std::vector<float> next_x, next_y;        // The point being approached
+    std::vector<float> phase, inc;            // Position between them, and its step per sample
+    std::vector<float> gain_l, gain_r;
+    std::vector<int> age, length, delay;
+
+    // Orbit state while the chunk's points are computed
+    std::vector<float> step_x, step_y;
+
+    // Chunk points, grain-major: points[g * points_per_grain + k]
+    std::vector<float> points_x, points_y;
+
+    std::array<float, window_size + 1> window;
+};
@@ -0,0 +1,242 @@
+/*
+  ==============================================================================
+
+    JobSystem.cpp
+    Created: 27 Oct 2026 6:18:52pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#include "JobSystem.h"
+#include "PerfTrace.h"
+
+class JobSystem::Worker : public juce::Thread {
+public:
+    Worker(JobSystem& o, int index)
+        : juce::Thread("Job worker " + juce::String(index)), owner(o)
+    {
+    }
+
+    void run() override
+    {
+        PerfTrace::nameThread("Jobs");
+        current = this;
+
+        while (!threadShouldExit()) {
+            Job job;
+            if (owner.take(&queue, job)) {
+                owner.execute(job);
+                continue;
+            }
+
+            sleeping = true;
+            // Anything queued before the flag was up would otherwise wait for the next wake
+            if (owner.take(&queue, job)) {
+                sleeping = false;
+                owner.execute(job);
+                continue;
+            }
+            wait(-1);
+        }
+
+        current = nullptr;
+    }
+
+    JobSystem& owner;
+    Queue queue;
+    std::atomic<bool> sleeping { false };
+
+    // The worker running on this thread, if any
+    static thread_local Worker* current;
+};
+
+thread_local JobSystem::Worker* JobSystem::Worker::current = nullptr;
+
+//==============================================================================
+JobSystem::CancellationToken::CancellationToken()
+    : state(std::make_shared<State>())
+{
+}
+
+JobSystem::CancellationToken JobSystem::CancellationToken::child() const
+{
+    CancellationToken token;
+    token.state->parent = state;
+    return token;
+}
+
+bool JobSystem::CancellationToken::isCancelled() const
+{
+    for (auto* s = state.get(); s != nullptr; s = s->parent.get()) {
+        if (s->cancelled) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::CancellationToken::cancelAndWait() const
+{
+    cancel();
+    // Jobs are short, a running one is usually done within a millisecond or two
+    while (state->running > 0) {
+        juce::Thread::sleep(1);
+    }
+}
+
+bool JobSystem::CancellationToken::enter() const
+{
+    // Counted before the check, so cancelAndWait either sees the count or this sees the flag
+    for (auto* s = state.get(); s != nullptr; s = s->parent.get()) {
+        ++s->running;
+    }
+    if (isCancelled()) {
+        leave();
+        return false;
+    }
+    return true;
+}
+
+void JobSystem::CancellationToken::leave() const
+{
+    for (auto* s = state.get(); s != nullptr; s = s->parent.get()) {
+        --s->running;
+    }
+}
+
+//==============================================================================
+JobSystem::JobSystem()
+{
+    // Leave a core free for the audio thread
+    const int numWorkers = juce::jmax(1, juce::SystemStats::getNumCpus() - 1);
+    for (int i = 0; i < numWorkers; ++i) {
+        workers.push_back(std::make_unique<Worker>(*this, i));
+    }
+    // Only once they're all there, a worker steals from every other one
+    for (auto& worker : workers) {
+        worker->startThread(juce::Thread::Priority::low);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    for (auto& worker : workers) {
+        worker->signalThreadShouldExit();
+        worker->notify();
+    }
+    for (auto& worker : workers) {
+        worker->stopThread(2000);
+    }
+}
+
+void JobSystem::submit(Priority priority, const CancellationToken& token, std::function<void()> job,
+                       std::function<void()> onComplete)
+{
+    auto* worker = Worker::current;
+    Queue& queue = (worker != nullptr && &worker->owner == this) ? worker->queue : shared;
+    {
+        const juce::SpinLock::ScopedLockType sl(queue.lock);
+        queue.jobs[priority].push_back({ token, std::move(job), std::move(onComplete) });
+    }
+    wakeOne();
+}
+
+void JobSystem::parallelFor(Priority priority, int count, const std::function<void(int)>& fn)
+{
+    if (count <= 0) {
+        return;
+    }
+
+    struct State {
+        std::atomic<int> next { 0 };
+        std::atomic<int> remaining { 0 };
+        juce::WaitableEvent done;
+    };
+    auto state = std::make_shared<State>();
+    state->remaining = count;
+
+    // A helper that only starts once every index is taken returns straight
+    // away, so it never touches fn after this has returned
+    auto work = [state, count, &fn] {
+        for (int i = state->next++; i < count; i = state->next++) {
+            fn(i);
+            if (--state->remaining == 0) {
+                state->done.signal();
+            }
+        }
+    };
+
+    const CancellationToken token;
+    const int numHelpers = juce::jmin(count - 1, getNumWorkers());
+    for (int i = 0; i < numHelpers; ++i) {
+        submit(priority, token, work);
+    }
+    work();
+    state->done.wait();
+}
+
+bool JobSystem::take(Queue* own, Job& job)
+{
+    auto pop = [&job](Queue& queue, int priority, bool newest) {
+        const juce::SpinLock::ScopedLockType sl(queue.lock);
+        auto& jobs = queue.jobs[priority];
+        if (jobs.empty()) {
+            return false;
+        }
+        if (newest) {
+            job = std::move(jobs.back());
+            jobs.pop_back();
+        }
+        else {
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        return true;
+    };
+
+    for (int p = num_priorities; --p >= 0;) {
+        if (own != nullptr && pop(*own, p, true)) {
+            return true;
+        }
+        if (pop(shared, p, false)) {
+            return true;
+        }
+        for (auto& worker : workers) {
+            if (&worker->queue != own && pop(worker->queue, p, false)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void JobSystem::execute(Job& job)
+{
+    if (!job.token.enter()) {
+        return;
+    }
+    {
+        PHRACTAL_TRACE_SCOPE("Job");
+        job.run();
+    }
+    job.token.leave();
+
+    if (job.onComplete) {
+        juce::MessageManager::callAsync([token = job.token, onComplete = std::move(job.onComplete)] {
+            if (!token.isCancelled()) {
+                onComplete();
+            }
+        });
+    }
+}
+
+void JobSystem::wakeOne()
+{
+    for (auto& worker : workers) {
+        if (worker->sleeping.exchange(false)) {
+            worker->notify();
+            return;
+        }
+    }
+}
@@ -0,0 +1,107 @@
+/*
+  ==============================================================================
+
+    JobSystem.h
+    Created: 27 Oct 2026 6:18:52pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Process-wide pool for the heavy work outside the audio thread: render passes,
+// tiles, exports and file writes. Held through a juce::SharedResourcePointer, so
+// every plugin instance in the host shares one set of threads instead of each
+// tool starting its own.
+//
+// There is one worker per core but one, at low priority, so the pool never
+// takes the core the host's audio thread runs on. Each worker has its own queues,
+// one per priority. Jobs submitted from a worker go on its own queues and are
+// taken newest first, which keeps follow-up work on a warm cache; jobs from other
+// threads go on a shared queue. An idle worker steals the oldest job of another.
+// A higher priority job anywhere is always taken before a lower one.
+//
+// Jobs are cancelled through their CancellationToken: a job whose token was
+// cancelled before it started is dropped, and its completion is never called.
+// A job that is already running finishes, it can poll the token to stop early.
+// Jobs still queued when the pool is destroyed are dropped.
+class JobSystem {
+public:
+    enum Priority { background, normal, interactive, num_priorities };
+
+    // Shared by copies. Children are cancelled with their parent, and a parent
+    // counts the running jobs of its children as its own, so cancelAndWait on a
+    // long-lived parent waits for every job submitted under it.
+    class CancellationToken {
+    public:
+        CancellationToken();
+
+        CancellationToken child() const;
+
+        void cancel() const { state->cancelled = true; }
+        bool isCancelled() const;
+
+        // Cancels, then waits for the running jobs of this token and its children.
+        // Never call it from one of those jobs.
+        void cancelAndWait() const;
+
+    private:
+        friend class JobSystem;
+
+        struct State {
+            std::shared_ptr<State> parent;
+            std::atomic<bool> cancelled { false };
+            std::atomic<int> running { 0 };
+        };
+        std::shared_ptr<State> state;
+
+        // Claims a run of the job, false if it's cancelled
+        bool enter() const;
+        void leave() const;
+    };
+
+    JobSystem();
+    ~JobSystem();
+
+    // Any thread but the audio thread. onComplete runs on the message thread
+    // after the job, unless the token is cancelled by then; the check happens on
+    // the message thread, so cancelling a token there before deleting what the
+    // completion captures is enough to make it safe.
+    void submit(Priority priority, const CancellationToken& token, std::function<void()> job,
+                std::function<void()> onComplete = {});
+
+    // Calls fn for every index in [0, count) on the pool and returns once all of
+    // them are done. The calling thread takes indices too, so it's safe to call
+    // from a job.
+    void parallelFor(Priority priority, int count, const std::function<void(int)>& fn);
+
+    int getNumWorkers() const { return int(workers.size()); }
+
+private:
+    class Worker;
+
+    struct Job {
+        CancellationToken token;
+        std::function<void()> run;
+        std::function<void()> onComplete;
+    };
+
+    struct Queue {
+        juce::SpinLock lock;
+        std::deque<Job> jobs[num_priorities];
+    };
+
+    // The next job for a worker, or false if every queue is empty
+    bool take(Queue* own, Job& job);
+    void execute(Job& job);
+    // Busy workers look for more work on their own
+    void wakeOne();
+
+    Queue shared;
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    JUCE_DECLARE_NON_COPYABLE (JobSystem)
+};
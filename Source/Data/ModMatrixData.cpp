@@ -0,0 +1,116 @@
+/*
+  ==============================================================================
+
+    ModMatrixData.cpp
+    Created: 21 Oct 2026 4:03:21pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#include "ModMatrixData.h"
+
+const juce::StringArray ModMatrixData::source_names { "None", "LFO 1", "LFO 2", "Mod envelope", "Mod wheel", "Velocity", "Aftertouch" };
+const juce::StringArray ModMatrixData::dest_names { "Start x", "Start y", "c.x", "c.y", "Gain" };
+
+// Full-scale modulation of each destination: fractal units for the points, gain factor for gain
+static const float dest_ranges[ModMatrixData::num_dests] = { 0.5f, 0.5f, 0.5f, 0.5f, 1.0f };
+
+void ModMatrixData::prepare(double newSampleRate, int samplesPerBlock) {
+    sampleRate = newSampleRate;
+    envelope.setSampleRate(sampleRate);
+    destBuffers.setSize(num_dests, samplesPerBlock);
+    sourceBuffers.setSize(3, samplesPerBlock);
+    constantRoutes.ensureStorageAllocated(num_slots);
+    movingRoutes.ensureStorageAllocated(num_slots);
+}
+
+void ModMatrixData::setSlots(const std::array<ModSlot, num_slots>& slots) {
+    constantRoutes.clearQuick();
+    movingRoutes.clearQuick();
+    for (const auto& slot : slots) {
+        if (slot.source <= none || slot.source >= num_sources || slot.dest < 0 || slot.dest >= num_dests || slot.amount == 0.0f) {
+            continue;
+        }
+        const Route route { slot.source, slot.dest, slot.amount * dest_ranges[slot.dest] };
+        if (isMoving(slot.source)) {
+            movingRoutes.add(route);
+        }
+        else {
+            constantRoutes.add(route);
+        }
+    }
+}
+
+void ModMatrixData::setLfoRates(float rate1, float rate2) {
+    lfoRate[0] = rate1;
+    lfoRate[1] = rate2;
+}
+
+void ModMatrixData::setEnvelope(float attack, float decay, float sustain, float release) {
+    envelope.updateADSR(attack, decay, sustain, release);
+}
+
+void ModMatrixData::noteOn(float velocity) {
+    velocityValue = velocity;
+    lfoPhase[0] = lfoPhase[1] = 0.0;
+    envelope.noteOn();
+}
+
+void ModMatrixData::noteOff() {
+    envelope.noteOff();
+}
+
+int ModMatrixData::process(int numSamples) {
+    // Hosts may pass more than the prepared block size, which the buffers aren't sized for
+    numSamples = juce::jmin(numSamples, getMaxBlockSize());
+
+    offsets.fill(0.0f);
+    moving.fill(false);
+
+    for (const auto& route : constantRoutes) {
+        const float value = (route.source == modWheel ? modWheelValue
+                          : route.source == velocity ? velocityValue
+                          : aftertouchValue);
+        offsets[route.dest] += route.amount * value;
+    }
+
+    if (movingRoutes.isEmpty()) {
+        return numSamples;
+    }
+
+    // Only the sources something listens to are rendered
+    bool used[num_sources] = {};
+    for (const auto& route : movingRoutes) {
+        used[route.source] = true;
+    }
+    for (int i = 0; i < 2; ++i) {
+        if (!used[lfo1 + i]) {
+            continue;
+        }
+        float* out = sourceBuffers.getWritePointer(i);
+        const double inc = juce::MathConstants<double>::twoPi * lfoRate[i] / sampleRate;
+        double phase = lfoPhase[i];
+        for (int n = 0; n < numSamples; ++n) {
+            out[n] = float(std::sin(phase));
+            phase += inc;
+        }
+        lfoPhase[i] = std::fmod(phase, juce::MathConstants<double>::twoPi);
+    }
+    if (used[modEnvelope]) {
+        float* out = sourceBuffers.getWritePointer(2);
+        for (int n = 0; n < numSamples; ++n) {
+            out[n] = envelope.getNextSample();
+        }
+    }
+
+    for (const auto& route : movingRoutes) {
+        float* dest = destBuffers.getWritePointer(route.dest);
+        if (!moving[route.dest]) {
+            juce::FloatVectorOperations::clear(dest, numSamples);
+            moving[route.dest] = true;
+        }
+        juce::FloatVectorOperations::addWithMultiply(dest, sourceBuffers.getReadPointer(route.source - lfo1), route.amount, numSamples);
+    }
+    return numSamples;
+}
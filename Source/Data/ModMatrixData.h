@@ -0,0 +1,81 @@
+/*
+  ==============================================================================
+
+    ModMatrixData.h
+    Created: 21 Oct 2026 4:03:21pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ADSRData.h"
+
+struct ModSlot {
+    int source = 0; // ModMatrixData::Source
+    int dest = 0;   // ModMatrixData::Dest
+    float amount = 0.0f;
+};
+
+// Per-voice modulation matrix. Every block the slots are compiled into a flat
+// list of routes, split by source: MIDI sources (mod wheel, velocity, aftertouch)
+// only change between blocks and are summed once per block, while LFOs and the
+// mod envelope are rendered per sample, and only when a route uses them.
+// A destination without moving routes has no per-sample buffer at all.
+class ModMatrixData {
+public:
+    enum Source { none, lfo1, lfo2, modEnvelope, modWheel, velocity, aftertouch, num_sources };
+    enum Dest { startX, startY, cX, cY, gain, num_dests };
+
+    static const int num_slots = 4;
+    static const juce::StringArray source_names;
+    static const juce::StringArray dest_names;
+
+    void prepare(double sampleRate, int samplesPerBlock);
+    void setSlots(const std::array<ModSlot, num_slots>& slots);
+    void setLfoRates(float rate1, float rate2);
+    void setEnvelope(float attack, float decay, float sustain, float release);
+
+    void noteOn(float velocity);
+    void noteOff();
+    void setModWheel(float value) { modWheelValue = value; }
+    void setAftertouch(float value) { aftertouchValue = value; }
+
+    // Renders the modulation for the next numSamples samples, at most
+    // getMaxBlockSize() of them, and returns how many it rendered. Longer
+    // blocks are split by the caller.
+    int process(int numSamples);
+    int getMaxBlockSize() const { return destBuffers.getNumSamples(); }
+
+    // Block-rate part of a destination, including every constant source
+    float getOffset(int dest) const { return offsets[dest]; }
+    // Audio-rate part of a destination, or null if nothing moving is routed to it
+    const float* getMovingOffset(int dest) const { return moving[dest] ? destBuffers.getReadPointer(dest) : nullptr; }
+private:
+    struct Route {
+        int source;
+        int dest;
+        float amount;
+    };
+
+    static bool isMoving(int source) { return source == lfo1 || source == lfo2 || source == modEnvelope; }
+
+    double sampleRate = 48000.0;
+    juce::Array<Route> constantRoutes;
+    juce::Array<Route> movingRoutes;
+
+    std::array<float, num_dests> offsets {};
+    std::array<bool, num_dests> moving {};
+    juce::AudioBuffer<float> destBuffers;
+    juce::AudioBuffer<float> sourceBuffers;
+
+    float lfoRate[2] = { 1.0f, 0.25f };
+    double lfoPhase[2] = { 0.0, 0.0 };
+    ADSRData envelope;
+
+    float velocityValue = 0.0f;
+    float modWheelValue = 0.0f;
+    float aftertouchValue = 0.0f;
+};
@@ -0,0 +1,61 @@
+/*
+  ==============================================================================
+
+    ModMatrixDataTests.cpp
+    Created: 30 Oct 2026 2:41:18pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "ModMatrixData.h"
+
+// Blocks longer than the prepared size only render what the buffers hold, the
+// voice splits them. Run by the render benchmark, category "Phractal".
+class ModMatrixDataTests : public juce::UnitTest {
+public:
+    ModMatrixDataTests() : juce::UnitTest("ModMatrixData", "Phractal") {}
+
+    void runTest() override
+    {
+        std::array<ModSlot, ModMatrixData::num_slots> slots {};
+        slots[0] = { ModMatrixData::lfo1, ModMatrixData::startX, 1.0f };
+        slots[1] = { ModMatrixData::modEnvelope, ModMatrixData::gain, 1.0f };
+
+        ModMatrixData matrix;
+        matrix.prepare(48000.0, prepared_block);
+        matrix.setSlots(slots);
+        matrix.setLfoRates(5.0f, 1.0f);
+        matrix.setEnvelope(0.01f, 0.1f, 0.5f, 0.1f);
+        matrix.noteOn(1.0f);
+
+        beginTest("Blocks longer than prepared");
+        expectEquals(matrix.process(4 * prepared_block), prepared_block);
+        expectEquals(matrix.getMaxBlockSize(), prepared_block);
+        expect(inRange(matrix.getMovingOffset(ModMatrixData::startX), prepared_block, 0.5f));
+        expect(inRange(matrix.getMovingOffset(ModMatrixData::gain), prepared_block, 1.0f));
+
+        beginTest("Blocks up to the prepared size");
+        expectEquals(matrix.process(prepared_block / 2), prepared_block / 2);
+        expectEquals(matrix.process(prepared_block), prepared_block);
+    }
+
+private:
+    static const int prepared_block = 64;
+
+    static bool inRange(const float* data, int numSamples, float range)
+    {
+        if (data == nullptr) {
+            return false;
+        }
+        for (int i = 0; i < numSamples; ++i) {
+            if (!std::isfinite(data[i]) || std::abs(data[i]) > range) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+static ModMatrixDataTests modMatrixDataTests;
@@ -0,0 +1,354 @@
+/*
+  ==============================================================================
+
+    OrbitData.cpp
+    Created: 19 Oct 2026 9:58:03am
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#include "OrbitData.h"
+
+void OrbitData::prepareToPlay(double newSampleRate) {
+    sampleRate = newSampleRate;
+    steps = juce::jmax(1, juce::roundToInt(sampleRate / max_freq));
+    updateRate();
+    reset();
+}
+
+void OrbitData::setFractal(const int type) {
+    if (type == fractalType) {
+        return;
+    }
+    jassert(type >= 0 && type <= FormulaMap::custom_fractal);
+    fractalType = type;
+    normalized = (type == 0);
+    reset();
+}
+
+void OrbitData::setFormula(std::shared_ptr<const FormulaMap> map) {
+    if (map == formula) {
+        return;
+    }
+    // The old formula is still owned by the processor, so this never frees it
+    formula = std::move(map);
+    if (fractalType == FormulaMap::custom_fractal) {
+        reset();
+    }
+}
+
+void OrbitData::setPoint(float x, float y, float cx, float cy) {
+    start_x = x;
+    start_y = y;
+    start_cx = cx;
+    start_cy = cy;
+    reset();
+}
+
+void OrbitData::moveStart(float x, float y) {
+    const float dx = x - start_x;
+    const float dy = y - start_y;
+    start_x = x;
+    start_y = y;
+
+    if (paused) {
+        // Nothing is playing, an escaped orbit can only start over
+        reset();
+        return;
+    }
+    if (table != nullptr) {
+        // The table is the cycle of the old start
+        leaveTable();
+    }
+
+    // The history stays, so the kernel smooths the step like any other move of the point
+    play_x += dx;
+    play_y += dy;
+    detector.reset(play_x, play_y);
+    cycleLength = 0;
+    cycleRecorded = 0;
+    cyclePos = 0;
+}
+
+void OrbitData::setPitch(double ratio) {
+    pitch = ratio;
+    updateRate();
+}
+
+void OrbitData::setMovingConstant(const float* offsetX, const float* offsetY) {
+    moving_cx = offsetX;
+    moving_cy = offsetY;
+
+    const bool nowMoving = (offsetX != nullptr || offsetY != nullptr);
+    if (nowMoving != constantMoving) {
+        constantMoving = nowMoving;
+        detector.reset(play_x, play_y);
+        cycleLength = 0;
+        cycleRecorded = 0;
+        cyclePos = 0;
+        play_cx = start_cx;
+        play_cy = start_cy;
+    }
+    if (constantMoving && table != nullptr) {
+        // Baked tables are for a fixed c
+        leaveTable();
+    }
+}
+
+void OrbitData::updateRate() {
+    readInc = juce::jmin(pitch * max_freq / sampleRate, max_points_per_sample);
+    if (table != nullptr) {
+        // Same condition as picking the table up in reset: above one point per
+        // sample its harmonics would pass Nyquist
+        if (readInc > 1.0) {
+            leaveTable();
+        }
+        else {
+            tableInc = readInc * double(table->left.size()) / double(table->period);
+        }
+    }
+}
+
+void OrbitData::leaveTable() {
+    // Carries on live from where the table is, looping its cycle. The history is
+    // refilled from the points before it, so the kernel never reads a gap.
+    const int period = table->period;
+    jassert(period <= max_cycle_length);
+    const double point = tablePos * period / double(table->left.size());
+    const int backfill = int(std::ceil(SincKernel::half_taps * juce::jmax(1.0, readInc))) + 1;
+
+    mean_x = mean_y = 0.0f;
+    for (int k = 0; k < period; ++k) {
+        cycle_x[k] = table->orbit_x[k];
+        cycle_y[k] = table->orbit_y[k];
+        mean_x += cycle_x[k];
+        mean_y += cycle_y[k];
+    }
+    // The running mean of a settled cycle is its average
+    mean_x /= float(period);
+    mean_y /= float(period);
+
+    cycleLength = cycleRecorded = period;
+    cyclePos = ((int(point) - backfill) % period + period) % period;
+    play_x = cycle_x[cyclePos];
+    play_y = cycle_y[cyclePos];
+    detector.reset(play_x, play_y);
+    pointsWritten = 0;
+    readPos = backfill + (point - std::floor(point));
+
+    // Dropping it never frees it here, the cache still owns it
+    table = nullptr;
+}
+
+void OrbitData::reset() {
+    play_cx = start_cx;
+    play_cy = start_cy;
+    play_x = mean_x = start_x;
+    play_y = mean_y = start_y;
+    paused = false;
+
+    pointsWritten = 0;
+    readPos = 0.0;
+
+    detector.reset(play_x, play_y);
+    cycleLength = 0;
+    cycleRecorded = 0;
+    cyclePos = 0;
+
+    if (trail != nullptr) {
+        trail->push(play_x, play_y, trailVoice, true);
+    }
+    record(play_x, play_y, true);
+
+    // Dropping the old table never frees it here, the cache still owns it
+    table = nullptr;
+    if (tables != nullptr && fractalType != FormulaMap::custom_fractal) {
+        auto baked = tables->find(fractalType, start_x, start_y, start_cx, start_cy);
+        if (baked != nullptr && baked->steps == steps) {
+            if (baked->kind == OrbitWavetable::Kind::escaped) {
+                paused = true;
+            }
+            else if (baked->kind == OrbitWavetable::Kind::looping && readInc <= 1.0 && !constantMoving) {
+                // Tables hold harmonics up to half the orbit rate, which only stays
+                // below Nyquist while there is at most one point per sample
+                table = std::move(baked);
+                tablePos = 0.0;
+                tablePoint = 0;
+                updateRate();
+            }
+        }
+    }
+}
+
+void OrbitData::setTrail(OrbitTrailFifo* fifo, int voiceIndex) {
+    trail = fifo;
+    trailVoice = voiceIndex;
+}
+
+void OrbitData::setRecorder(PerformanceRecorder* newRecorder, int voiceIndex) {
+    recorder = newRecorder;
+    recordVoice = voiceIndex;
+}
+
+template <typename Map>
+void OrbitData::iterate(const Map& map) {
+    if (isLooping() && !constantMoving) {
+        play_x = cycle_x[cyclePos];
+        play_y = cycle_y[cyclePos];
+        if (++cyclePos == cycleLength) {
+            cyclePos = 0;
+        }
+    }
+    else {
+        map(play_x, play_y, play_cx, play_cy);
+        if (play_x * play_x + play_y * play_y > escape_radius_sq) {
+            paused = true;
+            return;
+        }
+
+        if (constantMoving) {
+            // No cycle to find while the map itself changes
+        }
+        else if (cycleLength == 0) {
+            const int period = detector.push(play_x, play_y);
+            if (period <= max_cycle_length) {
+                cycleLength = period;
+            }
+        }
+        else {
+            // Record one full period after the detection point, then start looping it
+            cycle_x[cycleRecorded] = play_x;
+            cycle_y[cycleRecorded] = play_y;
+            ++cycleRecorded;
+        }
+    }
+
+    if (trail != nullptr) {
+        trail->push(play_x, play_y, trailVoice, false);
+    }
+    record(play_x, play_y, false);
+
+    float dx, dy;
+    if (normalized) {
+        dx = play_x - play_cx;
+        dy = play_y - play_cy;
+        if (dx != 0.0f || dy != 0.0f) {
+            float dmag = 1.0f / std::sqrt(1e-12f + dx * dx + dy * dy);
+            dx *= dmag;
+            dy *= dmag;
+        }
+    }
+    else {
+        // Point is relative to mean
+        dx = play_x - mean_x;
+        dy = play_y - mean_y;
+    }
+
+    // Update mean
+    mean_x = mean_x * 0.99f + play_x * 0.01f;
+    mean_y = mean_y * 0.99f + play_y * 0.01f;
+
+    // Don't let the volume go to infinity, clamp.
+    float m = dx * dx + dy * dy;
+    if (m > 2.0f) {
+        dx *= 2.0f / m;
+        dy *= 2.0f / m;
+    }
+
+    const int slot = int(pointsWritten & (history_size - 1));
+    history_x[slot] = dx;
+    history_y[slot] = dy;
+    ++pointsWritten;
+}
+
+void OrbitData::getNextAudioBlock(juce::AudioBuffer<float>& buffer, int startSample, int numSamples) {
+    auto* left = buffer.getWritePointer(0, startSample);
+    auto* right = buffer.getWritePointer(buffer.getNumChannels() > 1 ? 1 : 0, startSample);
+    recordSample = recordOffset + startSample;
+
+    if (table != nullptr) {
+        renderTable(left, right, numSamples);
+        return;
+    }
+
+    const bool played = visitMap(fractalType, formula.get(), [&](const auto& map) {
+        renderLive(map, left, right, numSamples);
+    });
+    if (!played) {
+        juce::FloatVectorOperations::clear(left, numSamples);
+        juce::FloatVectorOperations::clear(right, numSamples);
+    }
+}
+
+template <typename Map>
+void OrbitData::renderLive(const Map& map, float* left, float* right, int numSamples) {
+    // Above one point per sample the kernel is stretched to the output Nyquist
+    const float cutoff = float(juce::jmin(1.0, 1.0 / readInc));
+    const int reach = int(std::ceil(SincKernel::half_taps / cutoff));
+    jassert(2 * reach < history_size);
+
+    const int firstSample = recordSample;
+    for (int i = 0; i < numSamples; ++i) {
+        const juce::int64 base = (juce::int64)readPos;
+        recordSample = firstSample + i;
+
+        // Iterate ahead until every point under the kernel is known
+        if (constantMoving) {
+            play_cx = start_cx + (moving_cx != nullptr ? moving_cx[i] : 0.0f);
+            play_cy = start_cy + (moving_cy != nullptr ? moving_cy[i] : 0.0f);
+        }
+        while (!paused && pointsWritten <= base + reach) {
+            iterate(map);
+        }
+        if (paused) {
+            juce::FloatVectorOperations::clear(left + i, numSamples - i);
+            juce::FloatVectorOperations::clear(right + i, numSamples - i);
+            return;
+        }
+
+        // Points before the first one are silence
+        float l = 0.0f, r = 0.0f;
+        for (juce::int64 k = juce::jmax(juce::int64(0), base - reach + 1); k <= base + reach; ++k) {
+            const float w = SincKernel::at(float(readPos - double(k)) * cutoff);
+            const int slot = int(k & (history_size - 1));
+            l += w * history_x[slot];
+            r += w * history_y[slot];
+        }
+        left[i] = l * cutoff;
+        right[i] = r * cutoff;
+
+        readPos += readInc;
+    }
+}
+
+void OrbitData::renderTable(float* left, float* right, int numSamples) {
+    const int size = int(table->left.size());
+    const float* tableLeft = table->left.data();
+    const float* tableRight = table->right.data();
+    const int firstSample = recordSample;
+
+    for (int i = 0; i < numSamples; ++i) {
+        const int point = int(tablePos * table->period / size);
+        if (point != tablePoint) {
+            if (trail != nullptr) {
+                trail->push(table->orbit_x[point], table->orbit_y[point], trailVoice, false);
+            }
+            recordSample = firstSample + i;
+            record(table->orbit_x[point], table->orbit_y[point], false);
+        }
+        tablePoint = point;
+
+        // The table is oversampled and band-limited, so linear interpolation is enough
+        const int j = int(tablePos);
+        const float t = float(tablePos - j);
+        const int k = (j + 1 == size ? 0 : j + 1);
+        left[i] = tableLeft[j] + t * (tableLeft[k] - tableLeft[j]);
+        right[i] = tableRight[j] + t * (tableRight[k] - tableRight[j]);
+
+        tablePos += tableInc;
+        if (tablePos >= size) {
+            tablePos -= size;
+        }
+    }
+}
@@ -0,0 +1,125 @@
+/*
+  ==============================================================================
+
+    OrbitData.h
+    Created: 19 Oct 2026 9:58:03am
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FractalMaps.h"
+#include "FormulaMap.h"
+#include "CycleDetector.h"
+#include "OrbitTrailFifo.h"
+#include "OrbitWavetableCache.h"
+#include "PerformanceRecorder.h"
+#include "SincKernel.h"
+
+// Plays the orbit of a point under the selected fractal map as a stereo signal:
+// x goes to the left channel, y to the right. The map is iterated at max_freq
+// points per second times the pitch ratio, and the points are resampled to the
+// sample rate with a windowed sinc, so any ratio plays without aliasing.
+// With a wavetable cache, points whose cycle has already been baked play the
+// table from the start instead of iterating, and new points are queued for baking.
+class OrbitData {
+public:
+    void prepareToPlay(double sampleRate);
+    void setFractal(const int type);
+    // Map played while the type is FormulaMap::custom_fractal. Null plays silence.
+    void setFormula(std::shared_ptr<const FormulaMap> map);
+    void setPoint(float x, float y, float cx, float cy);
+    // Moves the start point without restarting: the running orbit is nudged by
+    // as much as the start moved and carries on from there
+    void moveStart(float x, float y);
+    // Orbit points per second relative to max_freq
+    void setPitch(double ratio);
+    // Per-sample offsets added to c for the next block, or null. While c moves
+    // the map changes from point to point, so cycles aren't looped.
+    void setMovingConstant(const float* offsetX, const float* offsetY);
+    void reset();
+    void setTrail(OrbitTrailFifo* fifo, int voiceIndex);
+    void setWavetableCache(OrbitWavetableCache* cache) { tables = cache; }
+    void setRecorder(PerformanceRecorder* newRecorder, int voiceIndex);
+    // Where sample 0 of the buffers given to getNextAudioBlock lands in the
+    // processor's block, for stamping recorded points
+    void setRecordOffset(int offset) { recordOffset = offset; recordSample = offset; }
+    void getNextAudioBlock(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    bool isPaused() const { return paused; }
+    bool isLooping() const { return cycleLength > 0 && cycleRecorded == cycleLength; }
+    int getCycleLength() const { return cycleLength; }
+
+    static const int max_cycle_length = 4096;
+    // Orbit points per output sample are capped, which bounds the kernel width
+    static constexpr double max_points_per_sample = 4.0;
+    static const int history_size = 128;
+private:
+    // Compiled once per map by visitFractal, with the map inlined
+    template <typename Map> void iterate(const Map& map);
+    template <typename Map> void renderLive(const Map& map, float* left, float* right, int numSamples);
+    // Rechecks the table against the new rate, and leaves it when it can't play
+    void updateRate();
+    // Switches from the table to the live path without a gap
+    void leaveTable();
+    void renderTable(float* left, float* right, int numSamples);
+    void record(float x, float y, bool restart) {
+        if (recorder != nullptr) {
+            recorder->pushOrbitPoint(recordVoice, recordSample, fractalType, x, y, play_cx, play_cy, restart);
+        }
+    }
+
+    int fractalType = 0;
+    std::shared_ptr<const FormulaMap> formula;
+    bool normalized = true;
+    bool paused = true;
+
+    float start_x = 0.0f, start_y = 0.0f;
+    float start_cx = 0.0f, start_cy = 0.0f;
+    float play_x = 0.0f, play_y = 0.0f;
+    float play_cx = 0.0f, play_cy = 0.0f;
+    float mean_x = 0.0f, mean_y = 0.0f;
+
+    const float* moving_cx = nullptr;
+    const float* moving_cy = nullptr;
+    bool constantMoving = false;
+
+    OrbitTrailFifo* trail = nullptr;
+    int trailVoice = 0;
+
+    PerformanceRecorder* recorder = nullptr;
+    int recordVoice = 0;
+    int recordOffset = 0;
+    int recordSample = 0;
+
+    double sampleRate = sample_rate;
+    double pitch = 1.0;
+    int steps = sample_rate / max_freq;
+
+    // The last history_size points after processing, indexed by point number.
+    // Output sample i is read at point readPos, which runs half the kernel behind
+    // the newest point.
+    std::array<float, history_size> history_x;
+    std::array<float, history_size> history_y;
+    juce::int64 pointsWritten = 0;
+    double readPos = 0.0;
+    double readInc = double(max_freq) / sample_rate;
+
+    // Once the orbit has settled into a cycle, one period is recorded here and
+    // replayed instead of iterating the map.
+    CycleDetector detector;
+    std::array<float, max_cycle_length> cycle_x;
+    std::array<float, max_cycle_length> cycle_y;
+    int cycleLength = 0;
+    int cycleRecorded = 0;
+    int cyclePos = 0;
+
+    OrbitWavetableCache* tables = nullptr;
+    std::shared_ptr<const OrbitWavetable> table;
+    double tablePos = 0.0;
+    double tableInc = 1.0;
+    int tablePoint = 0;
+};
@@ -0,0 +1,104 @@
+/*
+  ==============================================================================
+
+    OrbitFile.cpp
+    Created: 26 Oct 2026 4:12:48pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#include "OrbitFile.h"
+
+namespace OrbitFile {
+
+Header makeHeader(double sampleRate, int numVoices) {
+    Header header {};
+    std::memcpy(header.magic, "PHORBIT1", 8);
+    header.version = version;
+    header.headerSize = sizeof(Header);
+    header.recordSize = sizeof(Record);
+    header.numVoices = juce::uint32(numVoices);
+    header.sampleRate = sampleRate;
+    return header;
+}
+
+bool isValid(const Header& header) {
+    return std::memcmp(header.magic, "PHORBIT1", 8) == 0
+        && header.version == version
+        && header.headerSize == sizeof(Header)
+        && header.recordSize == sizeof(Record);
+}
+
+bool Reader::open(const juce::File& file) {
+    // The structs are used in place, which only matches the file on little-endian hosts
+    jassert(!juce::ByteOrder::isBigEndian());
+
+    index.clear();
+    mapped = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+    if (mapped->getData() == nullptr || mapped->getSize() < sizeof(Header)) {
+        mapped.reset();
+        return false;
+    }
+
+    std::memcpy(&header, mapped->getData(), sizeof(Header));
+    if (!isValid(header)) {
+        mapped.reset();
+        return false;
+    }
+
+    const auto size = juce::uint64(mapped->getSize());
+    const auto indexBytes = juce::uint64(header.numChunks) * sizeof(IndexEntry);
+    if (header.indexOffset >= sizeof(Header) && header.indexOffset + indexBytes <= size) {
+        const auto* entries = reinterpret_cast<const IndexEntry*>(static_cast<const char*>(mapped->getData()) + header.indexOffset);
+        index.assign(entries, entries + header.numChunks);
+    }
+    else {
+        scanChunks();
+    }
+    return true;
+}
+
+void Reader::scanChunks() {
+    // The recording was cut off before the index was written, keep every whole chunk
+    const char* data = static_cast<const char*>(mapped->getData());
+    const auto size = juce::uint64(mapped->getSize());
+    juce::uint64 offset = sizeof(Header);
+    header.numRecords = 0;
+
+    while (offset + sizeof(ChunkHeader) <= size) {
+        ChunkHeader chunk;
+        std::memcpy(&chunk, data + offset, sizeof(ChunkHeader));
+        const auto end = offset + sizeof(ChunkHeader) + juce::uint64(chunk.numRecords) * sizeof(Record);
+        if (std::memcmp(chunk.magic, "CHNK", 4) != 0 || chunk.numRecords == 0 || end > size) {
+            break;
+        }
+
+        const auto* records = reinterpret_cast<const Record*>(data + offset + sizeof(ChunkHeader));
+        IndexEntry entry {};
+        entry.offset = offset;
+        entry.firstSample = chunk.firstSample;
+        entry.lastSample = records[chunk.numRecords - 1].sample;
+        entry.numRecords = chunk.numRecords;
+        index.push_back(entry);
+
+        header.numRecords += chunk.numRecords;
+        offset = end;
+    }
+    header.numChunks = juce::uint32(index.size());
+}
+
+const Record* Reader::getRecords(int chunk) const {
+    const char* data = static_cast<const char*>(mapped->getData());
+    return reinterpret_cast<const Record*>(data + index[size_t(chunk)].offset + sizeof(ChunkHeader));
+}
+
+int Reader::findChunk(juce::int64 sample) const {
+    // Samples only ever grow from chunk to chunk
+    const auto it = std::lower_bound(index.begin(), index.end(), sample, [](const IndexEntry& entry, juce::int64 s) {
+        return entry.lastSample < s;
+    });
+    return int(it - index.begin());
+}
+
+}
@@ -0,0 +1,102 @@
+/*
+  ==============================================================================
+
+    OrbitFile.h
+    Created: 26 Oct 2026 4:12:48pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Binary file of recorded orbit points, written next to the WAV of a recorded
+// performance. Everything is little-endian and 8-byte aligned, so a mapped file
+// can be read in place:
+//
+//   Header                  at 0
+//   Chunk                   ChunkHeader, then numRecords Records
+//   ...
+//   IndexEntry[numChunks]   at header.indexOffset
+//
+// The index and the totals in the header are written when the recording stops.
+// If it never did, indexOffset is 0 and the chunks can still be walked from the
+// end of the header.
+namespace OrbitFile {
+
+struct Header {
+    char magic[8];              // "PHORBIT1"
+    juce::uint32 version;
+    juce::uint32 headerSize;
+    juce::uint32 recordSize;
+    juce::uint32 numVoices;
+    double sampleRate;
+    juce::uint64 numRecords;
+    juce::uint64 indexOffset;
+    juce::uint32 numChunks;
+    juce::uint32 reserved[3];
+};
+
+struct ChunkHeader {
+    char magic[4];              // "CHNK"
+    juce::uint32 numRecords;
+    juce::int64 firstSample;
+};
+
+// One orbit point of one voice
+struct Record {
+    juce::int64 sample;         // Output sample being rendered when the point was computed
+    juce::uint16 voice;
+    juce::uint16 flags;
+    juce::int32 fractalType;
+    float x, y;
+    float cx, cy;
+};
+
+struct IndexEntry {
+    juce::uint64 offset;        // Of the chunk header
+    juce::int64 firstSample;
+    juce::int64 lastSample;
+    juce::uint32 numRecords;
+    juce::uint32 reserved;
+};
+
+static_assert(sizeof(Header) == 64, "Header layout");
+static_assert(sizeof(ChunkHeader) == 16, "Chunk header layout");
+static_assert(sizeof(Record) == 32, "Record layout");
+static_assert(sizeof(IndexEntry) == 32, "Index entry layout");
+
+// Record flags
+static const juce::uint16 restart_flag = 1; // First point of a new orbit
+
+static const juce::uint32 version = 1;
+
+Header makeHeader(double sampleRate, int numVoices);
+bool isValid(const Header& header);
+
+// Maps a finished or interrupted file and finds chunks by offset or by sample.
+class Reader {
+public:
+    bool open(const juce::File& file);
+
+    const Header& getHeader() const { return header; }
+    int getNumChunks() const { return int(index.size()); }
+    const IndexEntry& getIndexEntry(int chunk) const { return index[size_t(chunk)]; }
+
+    // The records of a chunk, pointing into the mapped file
+    const Record* getRecords(int chunk) const;
+
+    // The first chunk that may hold records at or after sample, or getNumChunks()
+    int findChunk(juce::int64 sample) const;
+
+private:
+    void scanChunks();
+
+    std::unique_ptr<juce::MemoryMappedFile> mapped;
+    Header header {};
+    std::vector<IndexEntry> index;
+};
+
+}
@@ -0,0 +1,65 @@
+/*
+  ==============================================================================
+
+    OrbitTrailFifo.h
+    Created: 19 Oct 2026 1:45:17pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+struct OrbitTrailPoint {
+    float x;
+    float y;
+    int voice;
+    bool restart; // First point of a new orbit, the trail should not connect to the previous one
+};
+
+// Wait-free single producer / single consumer queue carrying the orbit points of
+// the sounding voices from the audio thread to the fractal view. Pushing is a
+// no-op while no view is listening, and points are dropped when the queue is full.
+class OrbitTrailFifo {
+public:
+    // Consumer thread only. Whatever is still queued from before is skipped; only
+    // the consumer moves the read position, so the audio thread may be pushing meanwhile.
+    void setEnabled(bool shouldBeEnabled) {
+        if (shouldBeEnabled) {
+            fifo.finishedRead(fifo.getNumReady());
+        }
+        enabled = shouldBeEnabled;
+    }
+
+    bool isEnabled() const { return enabled; }
+
+    void push(float x, float y, int voice, bool restart) {
+        if (!enabled) {
+            return;
+        }
+        const auto scope = fifo.write(1);
+        if (scope.blockSize1 > 0) {
+            buffer[scope.startIndex1] = { x, y, voice, restart };
+        }
+    }
+
+    // Hands every queued point to fn, in the order they were pushed.
+    template <typename Fn>
+    void pop(Fn&& fn) {
+        const auto scope = fifo.read(fifo.getNumReady());
+        for (int i = 0; i < scope.blockSize1; ++i) {
+            fn(buffer[scope.startIndex1 + i]);
+        }
+        for (int i = 0; i < scope.blockSize2; ++i) {
+            fn(buffer[scope.startIndex2 + i]);
+        }
+    }
+
+    static const int capacity = 1 << 15;
+private:
+    juce::AbstractFifo fifo { capacity };
+    std::array<OrbitTrailPoint, capacity> buffer;
+    std::atomic<bool> enabled { false };
+};
@@ -0,0 +1,276 @@
+/*
+  ==============================================================================
+
+    OrbitWavetableCache.cpp
+    Created: 20 Oct 2026 4:52:26pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#include "OrbitWavetableCache.h"
+#include "CycleDetector.h"
+
+class OrbitWavetableCache::Baker : public juce::Thread {
+public:
+    Baker(OrbitWavetableCache& o) : juce::Thread("Orbit wavetable baker"), owner(o) {}
+
+    void run() override
+    {
+        // Polled, so the audio thread never has to signal anything
+        while (!threadShouldExit()) {
+            owner.bakePending();
+            wait(10);
+        }
+    }
+
+private:
+    OrbitWavetableCache& owner;
+};
+
+//==============================================================================
+OrbitWavetableCache::OrbitWavetableCache()
+{
+    baker = std::make_unique<Baker>(*this);
+    baker->startThread(juce::Thread::Priority::low);
+}
+
+OrbitWavetableCache::~OrbitWavetableCache()
+{
+    baker->stopThread(2000);
+}
+
+size_t OrbitWavetableCache::KeyHash::operator()(const Key& key) const
+{
+    size_t h = std::hash<int>()(key.type);
+    for (const auto v : { key.x, key.y, key.cx, key.cy }) {
+        h = h * 1000003u ^ std::hash<juce::int64>()(v);
+    }
+    return h;
+}
+
+juce::int64 OrbitWavetableCache::quantise(float v)
+{
+    return (juce::int64)std::llround(juce::jlimit(-1e12, 1e12, double(v) * quantise_scale));
+}
+
+void OrbitWavetableCache::prepare(double sampleRate)
+{
+    const int newSteps = juce::jmax(1, juce::roundToInt(sampleRate / max_freq));
+    if (newSteps == steps) {
+        return;
+    }
+    steps = newSteps;
+
+    std::list<Entry> old;
+    {
+        const juce::SpinLock::ScopedLockType sl(lock);
+        old.swap(lru);
+        index.clear();
+        bytes = 0;
+    }
+    for (auto& entry : old) {
+        retire(std::move(entry.second));
+    }
+}
+
+std::shared_ptr<const OrbitWavetable> OrbitWavetableCache::find(int type, float x, float y, float cx, float cy)
+{
+    const Key key { type, quantise(x), quantise(y), quantise(cx), quantise(cy) };
+    {
+        const juce::SpinLock::ScopedTryLockType sl(lock);
+        if (!sl.isLocked()) {
+            return {};
+        }
+        const auto it = index.find(key);
+        if (it != index.end()) {
+            lru.splice(lru.begin(), lru, it->second);
+            return it->second->second;
+        }
+    }
+
+    // Dropped if the queue is full, the next lookup asks again
+    const auto scope = requests.write(1);
+    if (scope.blockSize1 > 0) {
+        requestBuffer[scope.startIndex1] = key;
+    }
+    return {};
+}
+
+void OrbitWavetableCache::bakePending()
+{
+    // Free the evicted tables that no voice is playing any more
+    {
+        const juce::ScopedLock sl(retiredLock);
+        retired.erase(std::remove_if(retired.begin(), retired.end(), [](const auto& table) {
+            return table.use_count() == 1;
+        }), retired.end());
+    }
+
+    while (!baker->threadShouldExit()) {
+        Key key;
+        {
+            const auto scope = requests.read(1);
+            if (scope.blockSize1 == 0) {
+                return;
+            }
+            key = requestBuffer[scope.startIndex1];
+        }
+
+        // Voices ask again until the table is there, so the same key can be queued several times
+        {
+            const juce::SpinLock::ScopedLockType sl(lock);
+            if (index.count(key) > 0) {
+                continue;
+            }
+        }
+
+        const int bakeSteps = steps;
+        auto table = bake(key, bakeSteps);
+        if (bakeSteps == steps) {
+            insert(key, std::move(table));
+        }
+    }
+}
+
+void OrbitWavetableCache::insert(const Key& key, std::shared_ptr<const OrbitWavetable> table)
+{
+    std::vector<std::shared_ptr<const OrbitWavetable>> evicted;
+    {
+        const juce::SpinLock::ScopedLockType sl(lock);
+        bytes += table->getSizeInBytes();
+        lru.emplace_front(key, std::move(table));
+        index[key] = lru.begin();
+
+        while (bytes > max_bytes && lru.size() > 1) {
+            auto& oldest = lru.back();
+            bytes -= oldest.second->getSizeInBytes();
+            index.erase(oldest.first);
+            evicted.push_back(std::move(oldest.second));
+            lru.pop_back();
+        }
+    }
+    for (auto& t : evicted) {
+        retire(std::move(t));
+    }
+}
+
+void OrbitWavetableCache::retire(std::shared_ptr<const OrbitWavetable> table)
+{
+    // Nothing can pick up an evicted table, so if only we hold it, it can go right away
+    if (table.use_count() > 1) {
+        const juce::ScopedLock sl(retiredLock);
+        retired.push_back(std::move(table));
+    }
+}
+
+std::shared_ptr<OrbitWavetable> OrbitWavetableCache::bake(const Key& key, int steps)
+{
+    auto table = std::make_shared<OrbitWavetable>();
+    table->steps = steps;
+
+    const Fractal fractal = all_fractals[key.type];
+    float x = float(key.x / quantise_scale);
+    float y = float(key.y / quantise_scale);
+    const float cx = float(key.cx / quantise_scale);
+    const float cy = float(key.cy / quantise_scale);
+
+    // Run through the transient until the orbit settles into a cycle
+    CycleDetector detector;
+    detector.reset(x, y);
+    int period = 0;
+    for (int i = 0; i < bake_max_iters && period == 0; ++i) {
+        fractal(x, y, cx, cy);
+        if (x * x + y * y > escape_radius_sq) {
+            table->kind = OrbitWavetable::Kind::escaped;
+            return table;
+        }
+        period = detector.push(x, y);
+    }
+    if (period == 0 || period > max_period) {
+        return table;
+    }
+
+    table->period = period;
+    table->orbit_x.resize(period);
+    table->orbit_y.resize(period);
+    double mean_x = 0.0, mean_y = 0.0;
+    for (int k = 0; k < period; ++k) {
+        fractal(x, y, cx, cy);
+        table->orbit_x[k] = x;
+        table->orbit_y[k] = y;
+        mean_x += x;
+        mean_y += y;
+    }
+    mean_x /= period;
+    mean_y /= period;
+
+    // Same signal as OrbitData::iterate() derives from each point, with the
+    // running mean replaced by the mean of the cycle
+    std::vector<std::complex<double>> signal(period);
+    for (int k = 0; k < period; ++k) {
+        double dx, dy;
+        if (key.type == 0) {
+            dx = table->orbit_x[k] - cx;
+            dy = table->orbit_y[k] - cy;
+            if (dx != 0.0 || dy != 0.0) {
+                const double mag = 1.0 / std::sqrt(1e-12 + dx * dx + dy * dy);
+                dx *= mag;
+                dy *= mag;
+            }
+        }
+        else {
+            dx = table->orbit_x[k] - mean_x;
+            dy = table->orbit_y[k] - mean_y;
+        }
+        const double m = dx * dx + dy * dy;
+        if (m > 2.0) {
+            dx *= 2.0 / m;
+            dy *= 2.0 / m;
+        }
+        signal[k] = { dx, dy };
+    }
+
+    // DFT of the cycle, with left as the real and right as the imaginary part
+    std::vector<std::complex<double>> twiddle(period);
+    for (int k = 0; k < period; ++k) {
+        twiddle[k] = std::polar(1.0, -2.0 * juce::MathConstants<double>::pi * k / period);
+    }
+    std::vector<std::complex<double>> spectrum(period);
+    for (int m = 0; m < period; ++m) {
+        std::complex<double> sum = 0.0;
+        for (int k = 0; k < period; ++k) {
+            sum += signal[k] * twiddle[(juce::int64(m) * k) % period];
+        }
+        spectrum[m] = sum / double(period);
+    }
+
+    // Harmonics below half the orbit rate, which is what the windowed sinc in
+    // OrbitData passes, resynthesised with a conjugated forward FFT. An even
+    // period has its Nyquist harmonic split evenly between +h and -h.
+    const int length = period * steps;
+    const int size = juce::nextPowerOfTwo(length);
+    int order = 0;
+    while ((1 << order) < size) {
+        ++order;
+    }
+
+    std::vector<juce::dsp::Complex<float>> bins(size), samples(size);
+    for (int h = -period / 2; h <= period / 2; ++h) {
+        const double gain = (2 * std::abs(h) == period ? 0.5 : 1.0);
+        const auto c = spectrum[((h % period) + period) % period] * gain;
+        bins[(h + size) % size] = std::conj(juce::dsp::Complex<float>(float(c.real()), float(c.imag())));
+    }
+    juce::dsp::FFT fft(order);
+    fft.perform(bins.data(), samples.data(), false);
+
+    table->left.resize(size);
+    table->right.resize(size);
+    for (int i = 0; i < size; ++i) {
+        table->left[i] = samples[i].real();
+        table->right[i] = -samples[i].imag();
+    }
+
+    table->kind = OrbitWavetable::Kind::looping;
+    return table;
+}
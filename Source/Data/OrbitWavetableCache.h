@@ -0,0 +1,98 @@
+/*
+  ==============================================================================
+
+    OrbitWavetableCache.h
+    Created: 20 Oct 2026 4:52:26pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FractalMaps.h"
+
+// One cycle of a periodic orbit, baked into the signal OrbitData would play for
+// it once the orbit has settled.
+struct OrbitWavetable {
+    enum class Kind {
+        looping,   // left / right hold one cycle
+        escaped,   // The orbit leaves the escape radius, nothing to play
+        aperiodic  // No cycle found, the map has to be iterated live
+    };
+
+    Kind kind = Kind::aperiodic;
+    int period = 0;           // Orbit points per cycle
+    int steps = 0;            // Samples per orbit point the table was baked for
+    std::vector<float> left;  // One cycle over a power of two number of samples, at least period * steps
+    std::vector<float> right;
+    std::vector<float> orbit_x; // The cycle itself, for the trails
+    std::vector<float> orbit_y;
+
+    size_t getSizeInBytes() const {
+        return sizeof(OrbitWavetable) + sizeof(float) * (left.size() + right.size() + orbit_x.size() + orbit_y.size());
+    }
+};
+
+// Bounded LRU cache of baked orbits, keyed by fractal type and the start point and
+// map constant quantised to a 1 / quantise_scale grid. Lookups come from the audio
+// thread and never block or allocate: a miss queues the key and a background thread
+// bakes it. The table is the cycle band-limited to half the orbit rate, the same
+// signal OrbitData's windowed sinc produces, rebuilt from the DFT of the cycle.
+// Tables still held by a voice when they are evicted are freed by the baker later,
+// never on the audio thread.
+class OrbitWavetableCache {
+public:
+    OrbitWavetableCache();
+    ~OrbitWavetableCache();
+
+    // Tables depend on the number of samples per orbit point, so a new rate empties the cache.
+    void prepare(double sampleRate);
+
+    // Audio thread. Returns null on a miss (and queues a bake) or when the cache is busy.
+    std::shared_ptr<const OrbitWavetable> find(int type, float x, float y, float cx, float cy);
+
+    static const size_t max_bytes = 32 << 20;
+    static constexpr double quantise_scale = 16384.0;
+    static const int bake_max_iters = 1 << 16;
+    static const int max_period = 4096;
+private:
+    struct Key {
+        int type;
+        juce::int64 x, y, cx, cy;
+        bool operator==(const Key& other) const {
+            return type == other.type && x == other.x && y == other.y && cx == other.cx && cy == other.cy;
+        }
+    };
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+    using Entry = std::pair<Key, std::shared_ptr<const OrbitWavetable>>;
+
+    class Baker;
+
+    static juce::int64 quantise(float v);
+    static std::shared_ptr<OrbitWavetable> bake(const Key& key, int steps);
+    void bakePending();
+    void insert(const Key& key, std::shared_ptr<const OrbitWavetable> table);
+    void retire(std::shared_ptr<const OrbitWavetable> table);
+
+    juce::SpinLock lock;
+    std::list<Entry> lru; // Most recently used first
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+    size_t bytes = 0;
+    std::atomic<int> steps { sample_rate / max_freq };
+
+    // Evicted tables that a voice may still be playing
+    juce::CriticalSection retiredLock;
+    std::vector<std::shared_ptr<const OrbitWavetable>> retired;
+
+    static const int max_requests = 256;
+    juce::AbstractFifo requests { max_requests };
+    std::array<Key, max_requests> requestBuffer;
+
+    std::unique_ptr<Baker> baker;
+
+    JUCE_DECLARE_NON_COPYABLE (OrbitWavetableCache)
+};
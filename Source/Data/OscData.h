@@ -1,23 +0,0 @@
-/*
-  ==============================================================================
-
-    OscData.h
-    Created: 15 Mar 2025 2:39:26pm
-    Author:  tri99er
-
-  ==============================================================================
-*/
-
-#pragma once
-
-#include <JuceHeader.h>
-
-class OscData : public juce::dsp::Oscillator<float> {
-public:
-    void prepareToPlay(juce::dsp::ProcessSpec& spec);
-    void setWaveType(const int choice);
-    void setWaveFrequency(const int midiNoteNumber);
-    void getNextAudioBlock(juce::dsp::AudioBlock<float>& block);
-private:
-
-};
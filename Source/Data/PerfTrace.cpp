@@ -0,0 +1,195 @@
+/*
+  ==============================================================================
+
+    PerfTrace.cpp
+    Created: 24 Oct 2026 9:26:51am
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#include "PerfTrace.h"
+#include "JobSystem.h"
+
+namespace {
+    struct Event {
+        const char* name;
+        juce::int64 start;
+        juce::int64 end;
+    };
+
+    struct ThreadBuffer {
+        std::vector<Event> events;
+        // Events below count are complete, published with release
+        std::atomic<int> count { 0 };
+        std::atomic<int> dropped { 0 };
+        juce::Thread::ThreadID threadId = nullptr;
+        const char* label = nullptr;
+    };
+
+    std::array<ThreadBuffer, PerfTrace::max_threads> buffers;
+    std::atomic<bool> capturing { false };
+    // Threads inside record, past the capturing check
+    std::atomic<int> recording { 0 };
+    std::atomic<bool> writing { false };
+    std::atomic<int> generation { 0 };
+    std::atomic<int> claimed { 0 };
+    juce::int64 captureStart = 0;
+
+    struct LocalState {
+        int generation = -1;
+        ThreadBuffer* buffer = nullptr;
+        const char* label = nullptr;
+    };
+    thread_local LocalState local;
+
+    ThreadBuffer* getBuffer() {
+        const int current = generation.load(std::memory_order_acquire);
+        if (local.generation == current) {
+            return local.buffer;
+        }
+
+        local.generation = current;
+        local.buffer = nullptr;
+        const int index = claimed.fetch_add(1, std::memory_order_relaxed);
+        if (index < PerfTrace::max_threads) {
+            local.buffer = &buffers[index];
+            local.buffer->threadId = juce::Thread::getCurrentThreadId();
+            local.buffer->label = local.label != nullptr ? local.label
+                : juce::MessageManager::existsAndIsCurrentThread() ? "Message" : nullptr;
+        }
+        return local.buffer;
+    }
+
+    // Once capturing is off, a record that wasn't in yet sees that and stays out
+    void waitForRecorders() {
+        while (recording.load() != 0) {
+            juce::Thread::yield();
+        }
+    }
+}
+
+bool PerfTrace::start() {
+    JUCE_ASSERT_MESSAGE_THREAD
+    if (writing) {
+        return false;
+    }
+    capturing = false;
+    waitForRecorders();
+
+    // Allocated once and never moved, a thread that is still finishing an event
+    // from the previous capture can't write into freed memory
+    for (auto& buffer : buffers) {
+        if (buffer.events.empty()) {
+            buffer.events.resize(events_per_thread);
+        }
+        buffer.count.store(0, std::memory_order_relaxed);
+        buffer.dropped.store(0, std::memory_order_relaxed);
+        buffer.threadId = nullptr;
+        buffer.label = nullptr;
+    }
+    claimed = 0;
+    captureStart = juce::Time::getHighResolutionTicks();
+    generation.fetch_add(1, std::memory_order_release);
+    capturing = true;
+    return true;
+}
+
+void PerfTrace::stop() {
+    JUCE_ASSERT_MESSAGE_THREAD
+    capturing = false;
+    // So write sees every event complete
+    waitForRecorders();
+}
+
+bool PerfTrace::isCapturing() {
+    return capturing.load(std::memory_order_relaxed);
+}
+
+void PerfTrace::nameThread(const char* name) {
+    local.label = name;
+    if (local.buffer != nullptr) {
+        local.buffer->label = name;
+    }
+}
+
+void PerfTrace::record(const char* name, juce::int64 startTicks, juce::int64 endTicks) {
+    if (!isCapturing()) {
+        return;
+    }
+    // Counted in before the capturing flag is checked again, the other order
+    // from start and stop, so either they wait for this or this sees the flag
+    recording.fetch_add(1);
+    if (capturing.load()) {
+        if (auto* buffer = getBuffer()) {
+            const int index = buffer->count.load(std::memory_order_relaxed);
+            if (index >= int(buffer->events.size())) {
+                buffer->dropped.store(buffer->dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+            else {
+                buffer->events[size_t(index)] = { name, startTicks, endTicks };
+                buffer->count.store(index + 1, std::memory_order_release);
+            }
+        }
+    }
+    recording.fetch_sub(1, std::memory_order_release);
+}
+
+namespace {
+    bool writeFile(const juce::File& file) {
+        file.deleteFile();
+        juce::FileOutputStream out(file);
+        if (!out.openedOk()) {
+            return false;
+        }
+
+        const double microsPerTick = 1.0e6 / double(juce::Time::getHighResolutionTicksPerSecond());
+        const auto micros = [&](juce::int64 ticks) { return juce::String(double(ticks) * microsPerTick, 3); };
+
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        bool first = true;
+        const int numThreads = juce::jmin(claimed.load(), PerfTrace::max_threads);
+        for (int t = 0; t < numThreads; ++t) {
+            const auto& buffer = buffers[size_t(t)];
+            const int count = buffer.count.load(std::memory_order_acquire);
+            const juce::String label = buffer.label != nullptr ? juce::String(buffer.label)
+                : "Thread " + juce::String::toHexString((juce::pointer_sized_int)buffer.threadId);
+
+            out << (first ? "" : ",\n") << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << t
+                << ",\"args\":{\"name\":" << juce::JSON::toString(label) << "}}";
+            first = false;
+            if (buffer.dropped.load() > 0) {
+                out << ",\n{\"ph\":\"i\",\"s\":\"t\",\"name\":\"" << buffer.dropped.load() << " events dropped\",\"pid\":1,\"tid\":" << t
+                    << ",\"ts\":" << micros(buffer.events[size_t(count - 1)].end - captureStart) << "}";
+            }
+
+            for (int i = 0; i < count; ++i) {
+                const auto& event = buffer.events[size_t(i)];
+                out << ",\n{\"ph\":\"X\",\"name\":\"" << event.name << "\",\"pid\":1,\"tid\":" << t
+                    << ",\"ts\":" << micros(event.start - captureStart)
+                    << ",\"dur\":" << micros(event.end - event.start) << "}";
+            }
+        }
+        out << "\n]}\n";
+        out.flush();
+        return out.getStatus().wasOk();
+    }
+}
+
+void PerfTrace::write(const juce::File& file, std::function<void(bool)> onWritten) {
+    JUCE_ASSERT_MESSAGE_THREAD
+    jassert(!isCapturing() && !writing);
+
+    // start() leaves the buffers alone until the job is done
+    writing = true;
+    auto ok = std::make_shared<bool>(false);
+    juce::SharedResourcePointer<JobSystem> jobs;
+    jobs->submit(JobSystem::background, {}, [file, ok] {
+        *ok = writeFile(file);
+    }, [ok, onWritten = std::move(onWritten)] {
+        writing = false;
+        if (onWritten) {
+            onWritten(*ok);
+        }
+    });
+}
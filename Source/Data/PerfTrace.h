@@ -0,0 +1,70 @@
+/*
+  ==============================================================================
+
+    PerfTrace.h
+    Created: 24 Oct 2026 9:26:51am
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Scoped trace points on the audio, render and message threads, recorded while
+// a capture runs and written out as Chrome trace-event JSON, which opens in
+// chrome://tracing or ui.perfetto.dev.
+//
+// The event buffers are allocated by the first start(). During a capture each
+// thread claims one of them with its first event and is its only writer, so an
+// event is three stores and a release of the count: no locks, no allocation.
+// Outside a capture a scope is a single relaxed load. Writers count themselves
+// in and out of a capture, and start and stop wait for the ones still inside,
+// so no event of an old capture lands in the buffers of a new one.
+namespace PerfTrace {
+    // Message thread only. start() returns false while the last capture is still being written.
+    bool start();
+    void stop();
+    // Writes everything recorded by the last capture on the job pool, then calls
+    // onWritten here with whether it worked. Call after stop().
+    void write(const juce::File& file, std::function<void(bool)> onWritten);
+
+    bool isCapturing();
+
+    // Label for the calling thread in the trace. Only the pointer is kept, so
+    // pass a string literal. The message thread is labelled automatically.
+    void nameThread(const char* name);
+
+    void record(const char* name, juce::int64 startTicks, juce::int64 endTicks);
+
+    class Scope {
+    public:
+        explicit Scope(const char* n)
+            : name(n), startTicks(isCapturing() ? juce::Time::getHighResolutionTicks() : 0)
+        {
+        }
+        ~Scope()
+        {
+            if (startTicks != 0) {
+                record(name, startTicks, juce::Time::getHighResolutionTicks());
+            }
+        }
+    private:
+        const char* name;
+        juce::int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE (Scope)
+    };
+
+    // Threads past this many aren't recorded
+    static const int max_threads = 12;
+    // Sized for this long a capture of the busiest thread, the audio thread at
+    // 1 ms blocks with its processBlock, renderBlock and renderVoices scopes
+    static const int capture_seconds = 30;
+    static const int audio_blocks_per_second = 1000;
+    static const int audio_scopes_per_block = 3;
+    static const int events_per_thread = capture_seconds * audio_blocks_per_second * audio_scopes_per_block;
+}
+
+#define PHRACTAL_TRACE_SCOPE(name) PerfTrace::Scope JUCE_JOIN_MACRO(perfTraceScope, __LINE__) (name)
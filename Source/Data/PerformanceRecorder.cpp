@@ -0,0 +1,254 @@
+/*
+  ==============================================================================
+
+    PerformanceRecorder.cpp
+    Created: 26 Oct 2026 4:12:48pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#include "PerformanceRecorder.h"
+#include "PerfTrace.h"
+
+// How long the writer sleeps between drains. The rings hold several seconds.
+static const int drain_interval_ms = 20;
+static const int scratch_samples = 8192;
+
+PerformanceRecorder::PerformanceRecorder()
+    : juce::Thread("Performance recorder")
+{
+}
+
+PerformanceRecorder::~PerformanceRecorder()
+{
+    stop();
+}
+
+bool PerformanceRecorder::start(const juce::File& wavFile, double sampleRate, int numVoices, juce::String& error)
+{
+    stop();
+
+    if (audioLeft.empty()) {
+        audioLeft.resize(audio_capacity);
+        audioRight.resize(audio_capacity);
+        orbitRing.resize(orbit_capacity);
+    }
+    scratch.setSize(2, scratch_samples);
+    chunk.reserve(chunk_records);
+
+    wavFile.deleteFile();
+    auto wavStream = std::make_unique<juce::FileOutputStream>(wavFile);
+    if (wavStream->failedToOpen()) {
+        error = "Couldn't write " + wavFile.getFullPathName();
+        return false;
+    }
+    juce::WavAudioFormat wav;
+    wavWriter.reset(wav.createWriterFor(wavStream.get(), sampleRate, 2, 32, {}, 0));
+    if (wavWriter == nullptr) {
+        error = "Couldn't create a WAV writer";
+        return false;
+    }
+    wavStream.release(); // Owned by the writer now
+
+    orbitFile = wavFile.withFileExtension("orbit");
+    orbitFile.deleteFile();
+    orbitStream = std::make_unique<juce::FileOutputStream>(orbitFile);
+    if (orbitStream->failedToOpen()) {
+        error = "Couldn't write " + orbitFile.getFullPathName();
+        orbitStream.reset();
+        wavWriter.reset();
+        return false;
+    }
+    header = OrbitFile::makeHeader(sampleRate, numVoices);
+    orbitStream->write(&header, sizeof(header));
+
+    index.clear();
+    chunk.clear();
+    samplesWritten = 0;
+
+    // The writer accepts it once the rings are clear of the previous recording
+    if (++startedGeneration <= 0) {
+        startedGeneration = 1;
+    }
+    startThread(juce::Thread::Priority::normal);
+    recording = true;
+    return true;
+}
+
+void PerformanceRecorder::stop()
+{
+    if (!recording) {
+        return;
+    }
+    recording = false;
+    stopThread(2000);
+
+    // Withdrawn once the writer is gone, so it can't accept the recording after
+    // this. Unless it had, the rings only hold what the previous one left.
+    if (acceptedGeneration.exchange(0) != 0) {
+        // Whatever the last blocks pushed before seeing the flag
+        drain();
+    }
+    finish();
+}
+
+void PerformanceRecorder::beginBlock()
+{
+    const int generation = acceptedGeneration.load();
+    busyGeneration = generation;
+    // Checked again once the block is announced. If the writer of a new recording
+    // found no block busy, the generation was withdrawn before that, and this sees it.
+    blockActive = (generation != 0 && acceptedGeneration.load() == generation);
+    if (!blockActive) {
+        busyGeneration = 0;
+        return;
+    }
+    if (generation != blockGeneration) {
+        // First block of a new recording
+        blockGeneration = generation;
+        blockStart = 0;
+    }
+}
+
+void PerformanceRecorder::pushAudio(const juce::AudioBuffer<float>& buffer, int numSamples)
+{
+    if (!blockActive) {
+        return;
+    }
+    blockActive = false;
+    blockStart += numSamples;
+    pushBlock(buffer, numSamples);
+    busyGeneration = 0;
+}
+
+void PerformanceRecorder::pushBlock(const juce::AudioBuffer<float>& buffer, int numSamples)
+{
+    if (buffer.getNumChannels() == 0) {
+        return;
+    }
+
+    // A block that doesn't fit whole is dropped whole, the writer fills the gap with silence
+    if (audioFifo.getFreeSpace() < numSamples) {
+        droppedSamples += numSamples;
+        return;
+    }
+
+    const float* left = buffer.getReadPointer(0);
+    const float* right = buffer.getReadPointer(buffer.getNumChannels() > 1 ? 1 : 0);
+    const auto scope = audioFifo.write(numSamples);
+    if (scope.blockSize1 > 0) {
+        juce::FloatVectorOperations::copy(audioLeft.data() + scope.startIndex1, left, scope.blockSize1);
+        juce::FloatVectorOperations::copy(audioRight.data() + scope.startIndex1, right, scope.blockSize1);
+    }
+    if (scope.blockSize2 > 0) {
+        juce::FloatVectorOperations::copy(audioLeft.data() + scope.startIndex2, left + scope.blockSize1, scope.blockSize2);
+        juce::FloatVectorOperations::copy(audioRight.data() + scope.startIndex2, right + scope.blockSize1, scope.blockSize2);
+    }
+}
+
+void PerformanceRecorder::run()
+{
+    PerfTrace::nameThread("Recorder");
+
+    // A block of the previous recording may still be running, it pushed its
+    // start before stop withdrew that recording. Whatever it leaves is skipped.
+    while (busyGeneration != 0) {
+        if (threadShouldExit()) {
+            return;
+        }
+        wait(1);
+    }
+    audioFifo.finishedRead(audioFifo.getNumReady());
+    orbitFifo.finishedRead(orbitFifo.getNumReady());
+    droppedSamples = 0;
+    droppedPoints = 0;
+    gapsWritten = 0;
+    acceptedGeneration = startedGeneration;
+
+    while (!threadShouldExit()) {
+        drain();
+        wait(drain_interval_ms);
+    }
+}
+
+void PerformanceRecorder::drain()
+{
+    PHRACTAL_TRACE_SCOPE("Recorder drain");
+
+    while (audioFifo.getNumReady() > 0) {
+        const auto scope = audioFifo.read(juce::jmin(audioFifo.getNumReady(), scratch_samples));
+        const int count = scope.blockSize1 + scope.blockSize2;
+        if (scope.blockSize1 > 0) {
+            scratch.copyFrom(0, 0, audioLeft.data() + scope.startIndex1, scope.blockSize1);
+            scratch.copyFrom(1, 0, audioRight.data() + scope.startIndex1, scope.blockSize1);
+        }
+        if (scope.blockSize2 > 0) {
+            scratch.copyFrom(0, scope.blockSize1, audioLeft.data() + scope.startIndex2, scope.blockSize2);
+            scratch.copyFrom(1, scope.blockSize1, audioRight.data() + scope.startIndex2, scope.blockSize2);
+        }
+        wavWriter->writeFromAudioSampleBuffer(scratch, 0, count);
+        samplesWritten += count;
+    }
+
+    // Silence for dropped blocks keeps the WAV in step with the orbit samples. It
+    // lands after what was queued when the drop was counted, so at most one drain
+    // interval early.
+    const juce::int64 gap = droppedSamples - gapsWritten;
+    if (gap > 0) {
+        scratch.clear();
+        for (juce::int64 done = 0; done < gap; done += scratch_samples) {
+            const int count = int(juce::jmin(juce::int64(scratch_samples), gap - done));
+            wavWriter->writeFromAudioSampleBuffer(scratch, 0, count);
+        }
+        samplesWritten += gap;
+        gapsWritten += gap;
+    }
+
+    orbitFifo.read(orbitFifo.getNumReady()).forEach([this](int i) {
+        chunk.push_back(orbitRing[size_t(i)]);
+        if (int(chunk.size()) == chunk_records) {
+            writeChunk();
+        }
+    });
+}
+
+void PerformanceRecorder::writeChunk()
+{
+    if (chunk.empty()) {
+        return;
+    }
+
+    OrbitFile::IndexEntry entry {};
+    entry.offset = juce::uint64(orbitStream->getPosition());
+    entry.firstSample = chunk.front().sample;
+    entry.lastSample = chunk.back().sample;
+    entry.numRecords = juce::uint32(chunk.size());
+    index.push_back(entry);
+
+    OrbitFile::ChunkHeader chunkHeader {};
+    std::memcpy(chunkHeader.magic, "CHNK", 4);
+    chunkHeader.numRecords = entry.numRecords;
+    chunkHeader.firstSample = entry.firstSample;
+    orbitStream->write(&chunkHeader, sizeof(chunkHeader));
+    orbitStream->write(chunk.data(), chunk.size() * sizeof(OrbitFile::Record));
+
+    header.numRecords += entry.numRecords;
+    chunk.clear();
+}
+
+void PerformanceRecorder::finish()
+{
+    writeChunk();
+
+    // The index goes at the end, then the header is patched to point at it
+    header.indexOffset = juce::uint64(orbitStream->getPosition());
+    header.numChunks = juce::uint32(index.size());
+    orbitStream->write(index.data(), index.size() * sizeof(OrbitFile::IndexEntry));
+    orbitStream->setPosition(0);
+    orbitStream->write(&header, sizeof(header));
+    orbitStream->flush();
+
+    orbitStream.reset();
+    wavWriter.reset();
+}
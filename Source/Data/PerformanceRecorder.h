@@ -0,0 +1,109 @@
+/*
+  ==============================================================================
+
+    PerformanceRecorder.h
+    Created: 26 Oct 2026 4:12:48pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "OrbitFile.h"
+
+// Records a performance: the stereo output to a WAV file, and every orbit point
+// the voices compute, with its c and map, to an OrbitFile next to it.
+// The audio thread only copies into two preallocated wait-free rings; a writer
+// thread drains them to disk. Nothing on the audio thread locks, allocates or
+// touches a file, and whatever doesn't fit in a ring is dropped and counted.
+class PerformanceRecorder : private juce::Thread {
+public:
+    PerformanceRecorder();
+    ~PerformanceRecorder() override;
+
+    // Message thread. The orbit file is wavFile with the .orbit extension.
+    bool start(const juce::File& wavFile, double sampleRate, int numVoices, juce::String& error);
+    void stop();
+    bool isRecording() const { return recording; }
+    juce::File getOrbitFile() const { return orbitFile; }
+
+    juce::int64 getDroppedSamples() const { return droppedSamples; }
+    juce::int64 getDroppedPoints() const { return droppedPoints; }
+
+    // Audio thread. beginBlock decides whether the whole block is recorded, so a
+    // block is never cut in half by start or stop.
+    void beginBlock();
+    // sample is relative to the start of the block
+    void pushOrbitPoint(int voice, int sample, int fractalType, float x, float y, float cx, float cy, bool restart) {
+        if (!blockActive) {
+            return;
+        }
+        const auto scope = orbitFifo.write(1);
+        if (scope.blockSize1 == 0) {
+            ++droppedPoints;
+            return;
+        }
+        auto& record = orbitRing[size_t(scope.startIndex1)];
+        record.sample = blockStart + sample;
+        record.voice = juce::uint16(voice);
+        record.flags = restart ? OrbitFile::restart_flag : 0;
+        record.fractalType = fractalType;
+        record.x = x;
+        record.y = y;
+        record.cx = cx;
+        record.cy = cy;
+    }
+    // At the end of every block, recorded or not, with the final output
+    void pushAudio(const juce::AudioBuffer<float>& buffer, int numSamples);
+
+    static const int audio_capacity = 1 << 18;
+    static const int orbit_capacity = 1 << 18;
+    // Orbit records per chunk of the orbit file
+    static const int chunk_records = 4096;
+private:
+    void run() override;
+    void pushBlock(const juce::AudioBuffer<float>& buffer, int numSamples);
+    void drain();
+    void writeChunk();
+    void finish();
+
+    std::atomic<bool> recording { false };
+    std::atomic<juce::int64> droppedSamples { 0 };
+    std::atomic<juce::int64> droppedPoints { 0 };
+
+    // The recording the audio thread may push to, 0 for none. Every start takes a
+    // new generation, and the writer only accepts it once a block still pushing
+    // to the previous one has ended and what it left in the rings is skipped.
+    std::atomic<int> acceptedGeneration { 0 };
+    // Generation of the block the audio thread is in, 0 between blocks
+    std::atomic<int> busyGeneration { 0 };
+    // Message thread
+    int startedGeneration = 0;
+
+    // Audio thread
+    bool blockActive = false;
+    int blockGeneration = 0;
+    juce::int64 blockStart = 0;
+
+    // Allocated by the first start and kept, the audio thread may still be
+    // finishing a block when stop returns
+    juce::AbstractFifo audioFifo { audio_capacity };
+    std::vector<float> audioLeft, audioRight;
+    juce::AbstractFifo orbitFifo { orbit_capacity };
+    std::vector<OrbitFile::Record> orbitRing;
+
+    // Writer thread while recording, message thread otherwise
+    std::unique_ptr<juce::AudioFormatWriter> wavWriter;
+    std::unique_ptr<juce::FileOutputStream> orbitStream;
+    juce::File orbitFile;
+    OrbitFile::Header header {};
+    std::vector<OrbitFile::IndexEntry> index;
+    std::vector<OrbitFile::Record> chunk;
+    juce::AudioBuffer<float> scratch;
+    juce::int64 samplesWritten = 0;
+    juce::int64 gapsWritten = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (PerformanceRecorder)
+};
@@ -0,0 +1,127 @@
+/*
+  ==============================================================================
+
+    PostChainData.cpp
+    Created: 21 Oct 2026 1:18:55pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#include "PostChainData.h"
+
+void PostChainData::prepare(double newSampleRate, int maxBlockSize) {
+    sampleRate = newSampleRate;
+    dcCoeff = float(1.0 - juce::MathConstants<double>::twoPi * dc_cutoff_hz / sampleRate);
+    lookahead = juce::jmax(1, juce::roundToInt(lookahead_ms * 0.001 * sampleRate));
+    delay.setSize(2, lookahead + juce::jmax(1, maxBlockSize));
+    reset();
+}
+
+void PostChainData::reset() {
+    for (int ch = 0; ch < 2; ++ch) {
+        dc_x[ch] = dc_y[ch] = 0.0f;
+    }
+    delay.clear();
+    meanSquare = 0.0f;
+    peak = 0.0f;
+    gain = 1.0f;
+    primed = false;
+}
+
+void PostChainData::flush(float* data, int numSamples) {
+    // NaN fails every comparison, so one test catches NaN, Inf and runaway values
+    for (int i = 0; i < numSamples; ++i) {
+        data[i] = (std::abs(data[i]) <= blow_up_level ? data[i] : 0.0f);
+    }
+}
+
+void PostChainData::softLimit(float* data, int numSamples) {
+    const float range = 1.0f - limiter_knee;
+    for (int i = 0; i < numSamples; ++i) {
+        const float a = std::abs(data[i]);
+        if (a > limiter_knee) {
+            const float limited = limiter_knee + range * juce::dsp::FastMathApproximations::tanh(juce::jmin(a - limiter_knee, 4.0f * range) / range);
+            data[i] = std::copysign(limited, data[i]);
+        }
+    }
+}
+
+void PostChainData::process(juce::AudioBuffer<float>& buffer, int numSamples) {
+    jassert(buffer.getNumChannels() == 2);
+
+    // Hosts may pass more than the prepared block size, which the delay line isn't sized for
+    const int maxChunk = delay.getNumSamples() - lookahead;
+    for (int pos = 0; pos < numSamples; pos += maxChunk) {
+        processChunk(buffer, pos, juce::jmin(maxChunk, numSamples - pos));
+    }
+}
+
+void PostChainData::processChunk(juce::AudioBuffer<float>& buffer, int startSample, int numSamples) {
+
+    float blockPeak = 0.0f;
+    float blockSquares = 0.0f;
+
+    for (int ch = 0; ch < 2; ++ch) {
+        float* data = buffer.getWritePointer(ch, startSample);
+        flush(data, numSamples);
+
+        // One-pole DC blocker, the only recursive stage
+        float x1 = dc_x[ch];
+        float y1 = dc_y[ch];
+        for (int i = 0; i < numSamples; ++i) {
+            const float x = data[i];
+            y1 = x - x1 + dcCoeff * y1;
+            x1 = x;
+            data[i] = y1;
+        }
+        dc_x[ch] = x1;
+        dc_y[ch] = y1;
+
+        // The block is the look-ahead for the output, which lags it by `lookahead` samples
+        juce::FloatVectorOperations::copy(delay.getWritePointer(ch, lookahead), data, numSamples);
+
+        const auto range = juce::FloatVectorOperations::findMinAndMax(data, numSamples);
+        blockPeak = juce::jmax(blockPeak, -range.getStart(), range.getEnd());
+        for (int i = 0; i < numSamples; ++i) {
+            blockSquares += data[i] * data[i];
+        }
+    }
+
+    // Level envelopes: RMS over rms_window_ms, peak with instant attack
+    const float blockMeanSquare = blockSquares / float(2 * numSamples);
+    if (!primed) {
+        meanSquare = blockMeanSquare;
+        peak = blockPeak;
+    }
+    else {
+        const float rmsCoeff = float(std::exp(-numSamples / (rms_window_ms * 0.001 * sampleRate)));
+        const float peakCoeff = float(std::exp(-numSamples / (peak_release_ms * 0.001 * sampleRate)));
+        meanSquare = blockMeanSquare + rmsCoeff * (meanSquare - blockMeanSquare);
+        peak = juce::jmax(blockPeak, peak * peakCoeff);
+    }
+
+    float target = target_rms / std::sqrt(meanSquare + 1e-12f);
+    target = juce::jmin(target, 1.0f / juce::jmax(peak, 1e-6f));
+    target = juce::jlimit(min_gain, max_gain, target);
+
+    // The first block after a reset starts at the right gain, later ones ramp
+    // within the look-ahead so the gain is down before a peak comes out
+    const float startGain = (primed ? gain : target);
+    const int ramp = juce::jmin(numSamples, lookahead);
+    for (int ch = 0; ch < 2; ++ch) {
+        float* data = buffer.getWritePointer(ch, startSample);
+        float* line = delay.getWritePointer(ch);
+
+        juce::FloatVectorOperations::copy(data, line, numSamples);
+        std::memmove(line, line + numSamples, sizeof(float) * size_t(lookahead));
+
+        buffer.applyGainRamp(ch, startSample, ramp, startGain, target);
+        if (numSamples > ramp) {
+            juce::FloatVectorOperations::multiply(data + ramp, target, numSamples - ramp);
+        }
+        softLimit(data, numSamples);
+    }
+    gain = target;
+    primed = true;
+}
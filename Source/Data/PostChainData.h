@@ -0,0 +1,53 @@
+/*
+  ==============================================================================
+
+    PostChainData.h
+    Created: 21 Oct 2026 1:18:55pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Per-voice clean-up of the stereo orbit signal, before the envelope: non-finite
+// and runaway samples are flushed, DC is removed with a one-pole blocker, the level
+// is normalised towards target_rms with a short look-ahead, and a soft limiter
+// catches whatever the normaliser lets through.
+class PostChainData {
+public:
+    void prepare(double sampleRate, int maxBlockSize);
+    void reset();
+    void process(juce::AudioBuffer<float>& buffer, int numSamples);
+
+    static constexpr float dc_cutoff_hz = 10.0f;
+    static constexpr float lookahead_ms = 3.0f;
+    static constexpr float rms_window_ms = 50.0f;
+    static constexpr float peak_release_ms = 200.0f;
+    static constexpr float target_rms = 0.25f;
+    static constexpr float min_gain = 1.0f / 64.0f;
+    static constexpr float max_gain = 16.0f;
+    static constexpr float limiter_knee = 0.8f;
+    static constexpr float blow_up_level = 1e4f; // Anything louder is treated like NaN
+private:
+    // At most the prepared block size
+    void processChunk(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+    static void flush(float* data, int numSamples);
+    static void softLimit(float* data, int numSamples);
+
+    double sampleRate = 48000.0;
+    float dcCoeff = 0.999f;
+    float dc_x[2] = { 0.0f, 0.0f };
+    float dc_y[2] = { 0.0f, 0.0f };
+
+    // Look-ahead delay: the last `lookahead` input samples, followed by the current block
+    juce::AudioBuffer<float> delay;
+    int lookahead = 0;
+
+    float meanSquare = 0.0f;
+    float peak = 0.0f;
+    float gain = 1.0f;
+    bool primed = false;
+};
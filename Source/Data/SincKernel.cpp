@@ -0,0 +1,42 @@
+/*
+  ==============================================================================
+
+    SincKernel.cpp
+    Created: 21 Oct 2026 9:36:48am
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "SincKernel.h"
+
+static const int table_size = SincKernel::half_taps * SincKernel::phases + 2;
+
+// Built during static initialisation, so the audio thread never sees it half done
+static const std::array<float, table_size> kernel = [] {
+    std::array<float, table_size> t {};
+    const double pi = juce::MathConstants<double>::pi;
+    for (int i = 0; i < table_size; ++i) {
+        const double x = double(i) / SincKernel::phases;
+        if (x >= SincKernel::half_taps) {
+            t[i] = 0.0f;
+            continue;
+        }
+        const double sinc = (i == 0 ? 1.0 : std::sin(pi * x) / (pi * x));
+        const double w = x / SincKernel::half_taps;
+        const double window = 0.42 + 0.5 * std::cos(pi * w) + 0.08 * std::cos(2.0 * pi * w);
+        t[i] = float(sinc * window);
+    }
+    return t;
+}();
+
+float SincKernel::at(float x) {
+    const float p = std::abs(x) * phases;
+    const int i = int(p);
+    if (i >= table_size - 1) {
+        return 0.0f;
+    }
+    const float t = p - float(i);
+    return kernel[i] + t * (kernel[i + 1] - kernel[i]);
+}
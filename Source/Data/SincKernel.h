@@ -0,0 +1,21 @@
+/*
+  ==============================================================================
+
+    SincKernel.h
+    Created: 21 Oct 2026 9:36:48am
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#pragma once
+
+// Blackman windowed sinc for resampling the orbit point stream, tabulated at
+// phases points per tap and linearly interpolated between them.
+namespace SincKernel {
+    static const int half_taps = 8;
+    static const int phases = 512;
+
+    // h(x) for x in orbit points, 0 outside |x| < half_taps
+    float at(float x);
+}
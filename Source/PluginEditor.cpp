@@ -11,13 +11,17 @@
 
 //==============================================================================
 PhractalAudioProcessorEditor::PhractalAudioProcessorEditor (PhractalAudioProcessor& p)
-    : AudioProcessorEditor (&p), audioProcessor (p), fr(audioProcessor), osc(audioProcessor.apvts, "OSCWAVETYPE"), adsr(audioProcessor.apvts)
+    : AudioProcessorEditor (&p), audioProcessor (p), fr(audioProcessor), osc(audioProcessor.apvts, "OSCWAVETYPE"), formula(audioProcessor), adsr(audioProcessor.apvts), modMatrix(audioProcessor.apvts), grains(audioProcessor.apvts), scope(audioProcessor)
 {
     setSize(1280, 720);
 
     addAndMakeVisible(fr);
     addAndMakeVisible(osc);
+    addAndMakeVisible(formula);
     addAndMakeVisible(adsr);
+    addAndMakeVisible(modMatrix);
+    addAndMakeVisible(grains);
+    addAndMakeVisible(scope);
 }
 
 PhractalAudioProcessorEditor::~PhractalAudioProcessorEditor()
@@ -34,7 +38,12 @@ void PhractalAudioProcessorEditor::resized()
 {
     auto bounds = getLocalBounds();
 
-    osc.setBounds(bounds.removeFromLeft(280));
+    auto left = bounds.removeFromLeft(280);
+    osc.setBounds(left.removeFromTop(40));
+    formula.setBounds(left.removeFromTop(56));
+    grains.setBounds(left.removeFromBottom(130));
+    modMatrix.setBounds(left);
     fr.setBounds(bounds.removeFromTop(500));
-    adsr.setBounds(bounds);
+    adsr.setBounds(bounds.removeFromLeft(bounds.getWidth() / 2));
+    scope.setBounds(bounds);
 }
@@ -13,6 +13,10 @@
 #include "UI/ADSRComponent.h"
 #include "UI/OscComponent.h"
 #include "UI/FractalRendererComponent.h"
+#include "UI/ModMatrixComponent.h"
+#include "UI/GrainComponent.h"
+#include "UI/FormulaComponent.h"
+#include "UI/SpectrumScopeComponent.h"
 
 //==============================================================================
 /**
@@ -34,7 +38,11 @@ private:
     
     FractalRendererComponent fr;
     OscComponent osc;
+    FormulaComponent formula;
     ADSRComponent adsr;
+    ModMatrixComponent modMatrix;
+    GrainComponent grains;
+    SpectrumScopeComponent scope;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PhractalAudioProcessorEditor)
 };
@@ -9,6 +9,8 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
+const char PhractalAudioProcessor::default_formula[] = "z^2 + c";
+
 //==============================================================================
 PhractalAudioProcessor::PhractalAudioProcessor()
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -23,11 +25,33 @@ PhractalAudioProcessor::PhractalAudioProcessor()
 #endif
 {
     synth.addSound(new SynthSound());
-    synth.addVoice(new SynthVoice());
+
+    for (int i = 0; i < num_voices; ++i) {
+        auto voice = new SynthVoice();
+        voice->getOrbit().setTrail(&orbitTrail, i);
+        voice->getOrbit().setWavetableCache(&orbitTables);
+        voice->getOrbit().setRecorder(&recorder, i);
+        synth.addVoice(voice);
+    }
+
+    for (int slot = 0; slot < ModMatrixData::num_slots; ++slot) {
+        const juce::String prefix = "MOD" + juce::String(slot + 1);
+        modSlotParams[slot].source = apvts.getRawParameterValue(prefix + "SOURCE");
+        modSlotParams[slot].dest = apvts.getRawParameterValue(prefix + "DEST");
+        modSlotParams[slot].amount = apvts.getRawParameterValue(prefix + "AMOUNT");
+    }
+
+    juce::String error;
+    const bool compiled = setFormula(default_formula, error);
+    jassert(compiled);
+    juce::ignoreUnused(compiled);
+
+    startTimer(retire_interval_ms);
 }
 
 PhractalAudioProcessor::~PhractalAudioProcessor()
 {
+    stopTimer();
 }
 
 //==============================================================================
@@ -65,7 +89,9 @@ bool PhractalAudioProcessor::isMidiEffect() const
 
 double PhractalAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    // A released note rings for the amp release, the post chain adds no tail of its own.
+    // Voices usually free themselves earlier, once the release becomes inaudible.
+    return apvts.getRawParameterValue("RELEASE")->load();
 }
 
 int PhractalAudioProcessor::getNumPrograms()
@@ -96,6 +122,7 @@ void PhractalAudioProcessor::changeProgramName (int index, const juce::String& n
 void PhractalAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
     synth.setCurrentPlaybackSampleRate(sampleRate);
+    orbitTables.prepare(sampleRate);
 
     for (int i = 0; i < synth.getNumVoices(); ++i) {
         if (auto voice = dynamic_cast<SynthVoice*>(synth.getVoice(i))) {
@@ -138,30 +165,107 @@ bool PhractalAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts)
 
 void PhractalAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    PerfTrace::nameThread("Audio");
+    PHRACTAL_TRACE_SCOPE("processBlock");
     juce::ScopedNoDenormals noDenormals;
+    recorder.beginBlock();
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-    for (int i = 0; i < synth.getNumVoices(); ++i) {
-        if (auto voice = dynamic_cast<SynthVoice*>(synth.getVoice(i))) {
-            auto& attack = *apvts.getRawParameterValue("ATTACK");
-            auto& decay = *apvts.getRawParameterValue("DECAY");
-            auto& sustain = *apvts.getRawParameterValue("SUSTAIN");
-            auto& release = *apvts.getRawParameterValue("RELEASE");
+    auto& oscWaveChoice = *apvts.getRawParameterValue("OSCWAVETYPE");
+    waveType = (int)oscWaveChoice.load();
+
+    // Nothing playing and no notes coming, the voices would only add silence.
+    // The clear above is free too once the buffer is already clear.
+    if (midiMessages.isEmpty() && !synth.isSounding()) {
+        audioTap.push(buffer, buffer.getNumSamples());
+        recorder.pushAudio(buffer, buffer.getNumSamples());
+        return;
+    }
 
-            auto& oscWaveChoice = *apvts.getRawParameterValue("OSCWAVETYPE");
+    auto& attack = *apvts.getRawParameterValue("ATTACK");
+    auto& decay = *apvts.getRawParameterValue("DECAY");
+    auto& sustain = *apvts.getRawParameterValue("SUSTAIN");
+    auto& release = *apvts.getRawParameterValue("RELEASE");
+
+    auto& lfo1Rate = *apvts.getRawParameterValue("LFO1RATE");
+    auto& lfo2Rate = *apvts.getRawParameterValue("LFO2RATE");
+    auto& modAttack = *apvts.getRawParameterValue("MODATTACK");
+    auto& modDecay = *apvts.getRawParameterValue("MODDECAY");
+    auto& modSustain = *apvts.getRawParameterValue("MODSUSTAIN");
+    auto& modRelease = *apvts.getRawParameterValue("MODRELEASE");
+
+    auto& engineChoice = *apvts.getRawParameterValue("ENGINE");
+    auto& grainSize = *apvts.getRawParameterValue("GRAINSIZE");
+    auto& grainDensity = *apvts.getRawParameterValue("GRAINDENSITY");
+    auto& grainJitter = *apvts.getRawParameterValue("GRAINJITTER");
+    auto& grainSpread = *apvts.getRawParameterValue("GRAINSPREAD");
+
+    {
+        const juce::SpinLock::ScopedTryLockType regionTryLock(grainRegionLock);
+        if (regionTryLock.isLocked()) {
+            liveGrainRegion = grainRegion;
+        }
+    }
+    float regionX0, regionY0, regionX1, regionY1;
+    if (liveGrainRegion.active) {
+        regionX0 = liveGrainRegion.x0;
+        regionY0 = liveGrainRegion.y0;
+        regionX1 = liveGrainRegion.x1;
+        regionY1 = liveGrainRegion.y1;
+    }
+    else {
+        regionX0 = orbitX.load() - grain_region_default;
+        regionY0 = orbitY.load() - grain_region_default;
+        regionX1 = orbitX.load() + grain_region_default;
+        regionY1 = orbitY.load() + grain_region_default;
+    }
 
-            waveType = (int)oscWaveChoice.load();
+    // A formula being swapped in is picked up on the next block
+    std::shared_ptr<const FormulaMap> liveFormula;
+    bool hasLiveFormula = false;
+    {
+        const juce::SpinLock::ScopedTryLockType formulaTryLock(formulaLock);
+        if (formulaTryLock.isLocked()) {
+            liveFormula = formula;
+            hasLiveFormula = true;
+        }
+    }
+
+    // Modulation routing, compiled into each voice's route list below
+    std::array<ModSlot, ModMatrixData::num_slots> modSlots;
+    for (int slot = 0; slot < ModMatrixData::num_slots; ++slot) {
+        modSlots[slot].source = (int)modSlotParams[slot].source->load();
+        modSlots[slot].dest = (int)modSlotParams[slot].dest->load();
+        modSlots[slot].amount = modSlotParams[slot].amount->load();
+    }
+
+    for (int i = 0; i < synth.getNumVoices(); ++i) {
+        if (auto voice = dynamic_cast<SynthVoice*>(synth.getVoice(i))) {
             voice->update(attack.load(), decay.load(), sustain.load(), release.load());
-            voice->getOscillator1().setWaveType(0);//                                                                 HARDCODED WAVE TYPE CHOICE
-            voice->getOscillator2().setWaveType(0);//                                                                 HARDCODED WAVE TYPE CHOICE
+            voice->updateModulation(modSlots, lfo1Rate.load(), lfo2Rate.load(),
+                modAttack.load(), modDecay.load(), modSustain.load(), modRelease.load());
+            if (hasLiveFormula) {
+                voice->getOrbit().setFormula(liveFormula);
+                voice->getGrains().setFormula(liveFormula);
+            }
+            voice->setEngine((int)engineChoice.load());
+            voice->getGrains().setFractal(waveType);
+            voice->getGrains().setRegion(regionX0, regionY0, regionX1, regionY1);
+            voice->getGrains().setShape(grainSize.load(), grainDensity.load(), grainJitter.load(), grainSpread.load());
+            // Points from orbits restarted here are stamped at the start of the block
+            voice->getOrbit().setRecordOffset(0);
+            voice->getOrbit().setFractal(waveType);
+            voice->setPoint(orbitX.load(), orbitY.load(), orbitCx.load(), orbitCy.load());
         }
     }
 
-    synth.renderNextBlock(buffer, midiMessages, 0, buffer.getNumSamples());
+    synth.renderBlock(buffer, midiMessages, buffer.getNumSamples());
+    audioTap.push(buffer, buffer.getNumSamples());
+    recorder.pushAudio(buffer, buffer.getNumSamples());
 }
 
 //==============================================================================
@@ -178,15 +282,40 @@ juce::AudioProcessorEditor* PhractalAudioProcessor::createEditor()
 //==============================================================================
 void PhractalAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
+    // The parameters, plus the GRAINREGION child written by setGrainRegion and
+    // the FORMULA property written by setFormula
+    const auto state = apvts.copyState();
+    if (auto xml = state.createXml()) {
+        copyXmlToBinary(*xml, destData);
+    }
 }
 
 void PhractalAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
+    auto xml = getXmlFromBinary(data, sizeInBytes);
+    if (xml == nullptr || !xml->hasTagName(apvts.state.getType())) {
+        return;
+    }
+    apvts.replaceState(juce::ValueTree::fromXml(*xml));
+
+    GrainRegion region;
+    const auto saved = apvts.state.getChildWithName("GRAINREGION");
+    if (saved.isValid()) {
+        region.active = true;
+        region.x0 = saved.getProperty("x0");
+        region.y0 = saved.getProperty("y0");
+        region.x1 = saved.getProperty("x1");
+        region.y1 = saved.getProperty("y1");
+    }
+    applyGrainRegion(region);
+
+    // Hosts restore state on the message thread, which setFormula needs. A saved
+    // formula always compiled when it was set; sessions from before it was
+    // saved get the default.
+    juce::String error;
+    if (!setFormula(apvts.state.getProperty("FORMULA", default_formula).toString(), error)) {
+        setFormula(default_formula, error);
+    }
 }
 
 int PhractalAudioProcessor::getWaveType() const
@@ -194,6 +323,73 @@ int PhractalAudioProcessor::getWaveType() const
     return waveType;
 }
 
+void PhractalAudioProcessor::setOrbitPoint(float x, float y, float cx, float cy)
+{
+    orbitX = x;
+    orbitY = y;
+    orbitCx = cx;
+    orbitCy = cy;
+}
+
+void PhractalAudioProcessor::setGrainRegion(float x0, float y0, float x1, float y1)
+{
+    auto saved = apvts.state.getOrCreateChildWithName("GRAINREGION", nullptr);
+    saved.setProperty("x0", x0, nullptr);
+    saved.setProperty("y0", y0, nullptr);
+    saved.setProperty("x1", x1, nullptr);
+    saved.setProperty("y1", y1, nullptr);
+    applyGrainRegion({ true, x0, y0, x1, y1 });
+}
+
+void PhractalAudioProcessor::clearGrainRegion()
+{
+    apvts.state.removeChild(apvts.state.getChildWithName("GRAINREGION"), nullptr);
+    applyGrainRegion({});
+}
+
+PhractalAudioProcessor::GrainRegion PhractalAudioProcessor::getGrainRegion() const
+{
+    const juce::SpinLock::ScopedLockType lock(grainRegionLock);
+    return grainRegion;
+}
+
+void PhractalAudioProcessor::applyGrainRegion(const GrainRegion& region)
+{
+    const juce::SpinLock::ScopedLockType lock(grainRegionLock);
+    grainRegion = region;
+}
+
+bool PhractalAudioProcessor::setFormula(const juce::String& source, juce::String& error)
+{
+    auto compiled = FormulaMap::compile(source, error);
+    if (compiled == nullptr) {
+        return false;
+    }
+
+    {
+        const juce::SpinLock::ScopedLockType lock(formulaLock);
+        if (formula != nullptr) {
+            retiredFormulas.push_back(formula);
+        }
+        formula = std::move(compiled);
+    }
+    apvts.state.setProperty("FORMULA", source, nullptr);
+    return true;
+}
+
+void PhractalAudioProcessor::timerCallback()
+{
+    // Whatever only the retired list still holds is no longer in any voice
+    retiredFormulas.erase(std::remove_if(retiredFormulas.begin(), retiredFormulas.end(),
+        [](const auto& old) { return old.use_count() == 1; }), retiredFormulas.end());
+}
+
+std::shared_ptr<const FormulaMap> PhractalAudioProcessor::getFormula() const
+{
+    const juce::SpinLock::ScopedLockType lock(formulaLock);
+    return formula;
+}
+
 //==============================================================================
 // This creates new instances of the plugin..
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
@@ -211,12 +407,35 @@ juce::AudioProcessorValueTreeState::ParameterLayout PhractalAudioProcessor::crea
     params.push_back(std::make_unique<juce::AudioParameterFloat>("SUSTAIN", "Sustain", juce::NormalisableRange<float>{0.1f, 1.f}, 1.f));
     params.push_back(std::make_unique<juce::AudioParameterFloat>("RELEASE", "Release", juce::NormalisableRange<float>{0.1f, 3.f}, 0.4f));
 
+    juce::StringArray waveTypes(fractal_labels, num_fractals);
+    waveTypes.add("Custom");
     params.push_back(std::make_unique<juce::AudioParameterChoice>(
         "OSCWAVETYPE",
         "Osc Wave Type",
-        juce::StringArray{ "Mandelbrot", "Burning ship", "Feather", "SFX", "Henon", "Duffing", "Ikeda", "Chirikov" },
+        waveTypes,
         0
     ));
 
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("ENGINE", "Engine", juce::StringArray{ "Orbit", "Granular" }, 0));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("GRAINSIZE", "Grain Size", juce::NormalisableRange<float>{0.005f, 0.5f, 0.f, 0.4f}, 0.06f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("GRAINDENSITY", "Grain Density", juce::NormalisableRange<float>{1.f, 2000.f, 0.f, 0.3f}, 100.f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("GRAINJITTER", "Grain Pitch Jitter", juce::NormalisableRange<float>{0.f, 12.f}, 0.f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("GRAINSPREAD", "Grain Spread", juce::NormalisableRange<float>{0.f, 1.f}, 0.5f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("LFO1RATE", "LFO 1 Rate", juce::NormalisableRange<float>{0.01f, 20.f, 0.f, 0.3f}, 1.f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("LFO2RATE", "LFO 2 Rate", juce::NormalisableRange<float>{0.01f, 20.f, 0.f, 0.3f}, 0.25f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("MODATTACK", "Mod Attack", juce::NormalisableRange<float>{0.01f, 5.f, 0.f, 0.5f}, 0.5f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("MODDECAY", "Mod Decay", juce::NormalisableRange<float>{0.01f, 5.f, 0.f, 0.5f}, 1.f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("MODSUSTAIN", "Mod Sustain", juce::NormalisableRange<float>{0.f, 1.f}, 0.5f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("MODRELEASE", "Mod Release", juce::NormalisableRange<float>{0.01f, 5.f, 0.f, 0.5f}, 0.5f));
+
+    for (int slot = 1; slot <= ModMatrixData::num_slots; ++slot) {
+        const juce::String prefix = "MOD" + juce::String(slot);
+        params.push_back(std::make_unique<juce::AudioParameterChoice>(prefix + "SOURCE", "Mod " + juce::String(slot) + " Source", ModMatrixData::source_names, 0));
+        params.push_back(std::make_unique<juce::AudioParameterChoice>(prefix + "DEST", "Mod " + juce::String(slot) + " Destination", ModMatrixData::dest_names, 2));
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(prefix + "AMOUNT", "Mod " + juce::String(slot) + " Amount", juce::NormalisableRange<float>{-1.f, 1.f}, 0.f));
+    }
+
     return { params.begin(), params.end() };
 }
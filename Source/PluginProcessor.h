@@ -11,11 +11,19 @@
 #include <JuceHeader.h>
 #include "SynthSound.h"
 #include "SynthVoice.h"
+#include "ScheduledSynthesiser.h"
+#include "Data/OrbitTrailFifo.h"
+#include "Data/AudioTapFifo.h"
+#include "Data/PerformanceRecorder.h"
+#include "Data/OrbitWavetableCache.h"
+#include "Data/FormulaMap.h"
+#include "Data/PerfTrace.h"
 
 //==============================================================================
 /**
 */
-class PhractalAudioProcessor  : public juce::AudioProcessor
+class PhractalAudioProcessor  : public juce::AudioProcessor,
+                                private juce::Timer
 {
 public:
     //==============================================================================
@@ -57,11 +65,85 @@ public:
 
     juce::AudioProcessorValueTreeState apvts{*this, nullptr, "Parameters", createParams()};
     int getWaveType() const;
+
+    // Start point and map constant for the orbits played by the voices, set from the fractal view.
+    void setOrbitPoint(float x, float y, float cx, float cy);
+
+    struct GrainRegion {
+        bool active = false;
+        float x0 = 0.0f, y0 = 0.0f, x1 = 0.0f, y1 = 0.0f;
+    };
+
+    // Where the granular engine starts its grains. Without a region they start
+    // within grain_region_default of the orbit point. Message thread only; the
+    // region is kept in the state tree, so it's saved with the plugin.
+    void setGrainRegion(float x0, float y0, float x1, float y1);
+    void clearGrainRegion();
+    // The region as last set or restored, any thread but the audio thread
+    GrainRegion getGrainRegion() const;
+
+    // Compiles the map played and drawn as the "Custom" wave type. Message thread only.
+    // On failure the previous formula stays and error says why. The source is
+    // kept in the state tree, so it's saved with the plugin.
+    bool setFormula(const juce::String& source, juce::String& error);
+    std::shared_ptr<const FormulaMap> getFormula() const;
+
+    // Orbit points of the sounding voices, drained by the fractal view to draw their trails.
+    OrbitTrailFifo& getOrbitTrail() { return orbitTrail; }
+
+    // The output of every block, for the analyser
+    AudioTapFifo& getAudioTap() { return audioTap; }
+
+    // Streams the output and the voices' orbit points to disk while recording
+    PerformanceRecorder& getRecorder() { return recorder; }
+
+    static const int num_voices = 16;
+    // Compiled at construction, so the "Custom" type plays without an editor
+    static const char default_formula[];
+    static constexpr float grain_region_default = 0.02f;
+    // How often retired formulas are checked for release
+    static const int retire_interval_ms = 1000;
 private:
-    juce::Synthesiser synth;
+    // Releases the retired formulas no voice holds any more
+    void timerCallback() override;
+
+    ScheduledSynthesiser synth;
     juce::AudioProcessorValueTreeState::ParameterLayout createParams();
 
     int waveType = 0;
+    std::atomic<float> orbitX { 0.0f };
+    std::atomic<float> orbitY { 0.0f };
+    std::atomic<float> orbitCx { 0.0f };
+    std::atomic<float> orbitCy { 0.0f };
+    OrbitTrailFifo orbitTrail;
+    AudioTapFifo audioTap;
+    PerformanceRecorder recorder;
+    OrbitWavetableCache orbitTables;
+
+    // Swapped under the lock, which the audio thread only ever tries, and only
+    // for as long as it takes to copy the pointer. Replaced formulas wait in
+    // retiredFormulas until no voice holds them any more, so the audio thread
+    // never drops the last reference; the timer releases them.
+    mutable juce::SpinLock formulaLock;
+    std::shared_ptr<const FormulaMap> formula;
+    std::vector<std::shared_ptr<const FormulaMap>> retiredFormulas;
+
+    // Copied whole under the lock, which the audio thread only ever tries, so it
+    // never mixes the corners of two regions; when the try fails it keeps
+    // liveGrainRegion, the one it read last.
+    mutable juce::SpinLock grainRegionLock;
+    GrainRegion grainRegion;
+    GrainRegion liveGrainRegion;
+
+    // Publishes a region to the audio thread and the view
+    void applyGrainRegion(const GrainRegion& region);
+
+    struct ModSlotParams {
+        std::atomic<float>* source = nullptr;
+        std::atomic<float>* dest = nullptr;
+        std::atomic<float>* amount = nullptr;
+    };
+    std::array<ModSlotParams, ModMatrixData::num_slots> modSlotParams;
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PhractalAudioProcessor)
@@ -0,0 +1,266 @@
+/*
+  ==============================================================================
+
+    AttractorDensityRenderer.cpp
+    Created: 20 Oct 2026 10:05:52am
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#include "AttractorDensityRenderer.h"
+#include "../Data/PerfTrace.h"
+
+// The image is tone mapped at most this often while it refines
+static const double tone_map_interval_ms = 100.0;
+
+class AttractorDensityRenderer::Worker : public juce::Thread {
+public:
+    Worker(AttractorDensityRenderer& o, int index)
+        : juce::Thread("Attractor density " + juce::String(index)), owner(o), random(juce::Random::getSystemRandom().nextInt64())
+    {
+    }
+
+    void run() override
+    {
+        PerfTrace::nameThread("Attractor density");
+        while (!threadShouldExit()) {
+            FractalView v;
+            int gen;
+            {
+                const juce::ScopedLock sl(owner.lock);
+                if (!owner.hasView) {
+                    gen = -1;
+                }
+                else {
+                    v = owner.view;
+                    gen = owner.generation;
+                }
+            }
+            if (gen < 0 || v.width <= 0 || v.height <= 0) {
+                wait(50);
+                continue;
+            }
+
+            PHRACTAL_TRACE_SCOPE("Density batch");
+            // Only sized when the view changes, after a batch just its touched bins are cleared
+            if (local.size() != size_t(v.width) * v.height) {
+                local.assign(size_t(v.width) * v.height, 0);
+            }
+            const juce::uint64 hits = runBatch(v, gen);
+
+            {
+                // Hits from an outdated view are dropped
+                const juce::ScopedLock sl(owner.lock);
+                if (gen == owner.generation && hits > 0) {
+                    for (const auto i : touched) {
+                        const juce::uint32 h = owner.histogram[i];
+                        owner.histogram[i] = (h > 0xffffffffu - local[i] ? 0xffffffffu : h + local[i]);
+                    }
+                    owner.mergedHits += hits;
+                }
+            }
+            for (const auto i : touched) {
+                local[i] = 0;
+            }
+            touched.clear();
+        }
+    }
+
+private:
+    juce::uint64 runBatch(const FractalView& v, int gen)
+    {
+        juce::uint64 hits = 0;
+        visitMap(v.type, v.formula.get(), [&](const auto& map) {
+            hits = runBatch(map, v, gen);
+        });
+        return hits;
+    }
+
+    // Orbits run max_lanes side by side. For formulas that pays for the bytecode
+    // dispatch once per instruction instead of once per orbit, for the kernels
+    // the lane loop vectorises, maps with sin and cos included (see FastTrig.h).
+    static void step(const FormulaMap& map, float* x, float* y, const float* cx, const float* cy, int lanes)
+    {
+        map.run(x, y, cx, cy, lanes);
+    }
+
+    template <typename Map>
+    static void step(const Map& map, float* x, float* y, const float* cx, const float* cy, int lanes)
+    {
+        for (int l = 0; l < lanes; ++l) {
+            map(x[l], y[l], cx[l], cy[l]);
+        }
+    }
+
+    template <typename Map>
+    juce::uint64 runBatch(const Map& map, const FractalView& v, int gen)
+    {
+        const int lanes = FormulaMap::max_lanes;
+        float x[lanes], y[lanes], cx[lanes], cy[lanes];
+        bool alive[lanes];
+        std::fill_n(cx, lanes, v.jx);
+        std::fill_n(cy, lanes, v.jy);
+        const float halfW = float(v.width) * 0.5f;
+        const float halfH = float(v.height) * 0.5f;
+        juce::uint64 hits = 0;
+
+        for (int o = 0; o < orbits_per_batch; o += lanes) {
+            if ((o & 255) == 0 && (gen != owner.generation || threadShouldExit())) {
+                return 0;
+            }
+
+            for (int l = 0; l < lanes; ++l) {
+                EscapeTimeRenderer::pixelToPoint(v, random.nextFloat() * float(v.width), random.nextFloat() * float(v.height), x[l], y[l]);
+                alive[l] = true;
+            }
+
+            for (int k = 0; k < orbit_length; ++k) {
+                // Escaped lanes keep running, their values are just never plotted
+                step(map, x, y, cx, cy, lanes);
+                int numAlive = 0;
+                for (int l = 0; l < lanes; ++l) {
+                    if (!alive[l]) {
+                        continue;
+                    }
+                    const float r = x[l] * x[l] + y[l] * y[l];
+                    if (!(r <= escape_radius_sq)) {
+                        alive[l] = false; // Escaped or NaN
+                        continue;
+                    }
+                    ++numAlive;
+                    if (k < orbit_transient) {
+                        continue;
+                    }
+                    const int px = int(std::floor((x[l] + v.cam_x) * v.cam_zoom + halfW));
+                    const int py = int(std::floor((y[l] + v.cam_y) * v.cam_zoom + halfH));
+                    if (px >= 0 && px < v.width && py >= 0 && py < v.height) {
+                        const juce::uint32 i = juce::uint32(py * v.width + px);
+                        if (local[i]++ == 0) {
+                            touched.push_back(i);
+                        }
+                        ++hits;
+                    }
+                }
+                if (numAlive == 0) {
+                    break;
+                }
+            }
+        }
+        return hits;
+    }
+
+    AttractorDensityRenderer& owner;
+    juce::Random random;
+    std::vector<juce::uint32> local;
+    // Bins of local hit in this batch, the only ones merged
+    std::vector<juce::uint32> touched;
+};
+
+//==============================================================================
+AttractorDensityRenderer::AttractorDensityRenderer()
+{
+}
+
+AttractorDensityRenderer::~AttractorDensityRenderer()
+{
+    stop();
+}
+
+void AttractorDensityRenderer::start()
+{
+    if (isRunning()) {
+        return;
+    }
+
+    const int numWorkers = juce::jmax(1, juce::SystemStats::getNumCpus() - 1);
+    for (int i = 0; i < numWorkers; ++i) {
+        workers.push_back(std::make_unique<Worker>(*this, i));
+        workers.back()->startThread(juce::Thread::Priority::low);
+    }
+}
+
+void AttractorDensityRenderer::stop()
+{
+    for (auto& worker : workers) {
+        worker->signalThreadShouldExit();
+    }
+    for (auto& worker : workers) {
+        worker->stopThread(2000);
+    }
+    workers.clear();
+}
+
+bool AttractorDensityRenderer::sameView(const FractalView& a, const FractalView& b) const
+{
+    if (a.type != b.type || a.formula != b.formula || a.width != b.width || a.height != b.height || a.jx != b.jx || a.jy != b.jy) {
+        return false;
+    }
+    // The camera eases towards its target, so tiny moves would otherwise restart forever
+    const float size = float(juce::jmax(a.width, a.height));
+    return std::abs(a.cam_x - b.cam_x) * a.cam_zoom < 0.05f
+        && std::abs(a.cam_y - b.cam_y) * a.cam_zoom < 0.05f
+        && std::abs(a.cam_zoom - b.cam_zoom) / a.cam_zoom * size < 0.05f;
+}
+
+void AttractorDensityRenderer::setView(const FractalView& newView)
+{
+    const juce::ScopedLock sl(lock);
+    if (hasView && sameView(view, newView)) {
+        return;
+    }
+
+    view = newView;
+    hasView = true;
+    histogram.assign(size_t(juce::jmax(0, view.width)) * juce::jmax(0, view.height), 0);
+    mergedHits = 0;
+    toneMappedHits = 0;
+    ++generation;
+}
+
+bool AttractorDensityRenderer::getImage(std::vector<juce::PixelARGB>& argb, int& width, int& height)
+{
+    const double now = juce::Time::getMillisecondCounterHiRes();
+    const juce::ScopedLock sl(lock);
+
+    if (!hasView || mergedHits == toneMappedHits) {
+        return false;
+    }
+    // The first image after a reset goes out straight away, refinements are throttled
+    if (toneMappedHits != 0 && now - lastToneMapTime < tone_map_interval_ms) {
+        return false;
+    }
+    toneMappedHits = mergedHits;
+    lastToneMapTime = now;
+
+    width = view.width;
+    height = view.height;
+    argb.resize(histogram.size());
+
+    juce::uint32 peak = 1;
+    for (const auto h : histogram) {
+        peak = juce::jmax(peak, h);
+    }
+
+    // Log density, so the sparse outer parts of the attractor stay visible
+    const float scale = 1.0f / std::log1p(float(peak));
+    for (size_t i = 0; i < histogram.size(); ++i) {
+        const float v = std::log1p(float(histogram[i])) * scale;
+        argb[i] = juce::PixelARGB(255,
+            (juce::uint8)juce::roundToInt(std::sqrt(v) * 255.0f),
+            (juce::uint8)juce::roundToInt(v * 255.0f),
+            (juce::uint8)juce::roundToInt(v * v * 255.0f));
+    }
+    return true;
+}
+
+void AttractorDensityRenderer::getDefaultParameter(int type, float& cx, float& cy)
+{
+    switch (type) {
+    case 4: cx = 1.4f; cy = 0.3f; break;   // Henon
+    case 5: cx = 2.75f; cy = 0.2f; break;  // Duffing
+    case 6: cx = 0.9f; cy = 0.9f; break;   // Ikeda
+    case 7: cx = 1.0f; cy = 0.97f; break;  // Chirikov standard map
+    default: cx = 0.0f; cy = 0.0f; break;
+    }
+}
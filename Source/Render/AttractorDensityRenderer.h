@@ -0,0 +1,63 @@
+/*
+  ==============================================================================
+
+    AttractorDensityRenderer.h
+    Created: 20 Oct 2026 10:05:52am
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "EscapeTimeRenderer.h"
+
+// Orbit density plot for the strange-attractor maps (Henon, Duffing, Ikeda,
+// Chirikov). Worker threads fire short orbits from random start points in the
+// view, using the same map kernels as the synth, and count where they land in
+// per-thread histograms. The bins a batch hit are merged into a shared histogram
+// after it, so the image keeps refining for as long as the view stays still.
+// The map constant c is taken from view.jx / view.jy.
+class AttractorDensityRenderer {
+public:
+    AttractorDensityRenderer();
+    ~AttractorDensityRenderer();
+
+    void start();
+    void stop();
+    bool isRunning() const { return !workers.empty(); }
+
+    // Restarts the accumulation if the framing, the map or c has moved.
+    void setView(const FractalView& view);
+
+    // Tone maps the merged histogram into argb. Returns false if nothing new was
+    // merged since the last call.
+    bool getImage(std::vector<juce::PixelARGB>& argb, int& width, int& height);
+
+    static bool isAttractor(int type) { return type >= 4; }
+
+    // Parameters with a well known attractor, used until a point is picked.
+    static void getDefaultParameter(int type, float& cx, float& cy);
+
+    static const int orbits_per_batch = 4096;
+    static const int orbit_length = 256;
+    static const int orbit_transient = 16;
+private:
+    class Worker;
+
+    bool sameView(const FractalView& a, const FractalView& b) const;
+
+    juce::CriticalSection lock;
+    FractalView view;
+    bool hasView = false;
+    std::atomic<int> generation { 0 };
+    std::vector<juce::uint32> histogram;
+    juce::uint64 mergedHits = 0;
+    juce::uint64 toneMappedHits = 0;
+    double lastToneMapTime = 0.0;
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    JUCE_DECLARE_NON_COPYABLE (AttractorDensityRenderer)
+};
@@ -0,0 +1,114 @@
+/*
+  ==============================================================================
+
+    EscapeTimeRenderer.cpp
+    Created: 19 Oct 2026 3:32:09pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#include "EscapeTimeRenderer.h"
+#include "../Data/CycleDetector.h"
+
+FractalView FractalView::scaledTo(int newWidth, int newHeight) const {
+    FractalView view = *this;
+    view.cam_zoom = cam_zoom * float(newWidth) / float(juce::jmax(1, width));
+    view.width = newWidth;
+    view.height = newHeight;
+    return view;
+}
+
+// Mirrors fractal() in the fragment shader, including the Brent cycle exit.
+template <typename Map>
+static void shade(const FractalView& view, const Map& map, float x, float y, float cx, float cy, float* rgb, float& escape) {
+    float px = x, py = y;
+    float sumx = 0.0f, sumy = 0.0f, sumz = 0.0f;
+    CycleDetector detector;
+    detector.reset(x, y);
+
+    int i;
+    int n = view.iters;
+    for (i = 0; i < view.iters; ++i) {
+        const float ppx = px, ppy = py;
+        px = x;
+        py = y;
+        map(x, y, cx, cy);
+        if (x * x + y * y > escape_radius_sq) {
+            break;
+        }
+        if (view.use_color) {
+            sumx += (x - px) * (px - ppx) + (y - py) * (py - ppy);
+            sumy += (x - px) * (x - px) + (y - py) * (y - py);
+            sumz += (x - ppx) * (x - ppx) + (y - ppy) * (y - ppy);
+        }
+        if (detector.push(x, y) > 0) {
+            n = i + 1;
+            i = view.iters;
+            break;
+        }
+    }
+
+    escape = float(i);
+    if (i != view.iters) {
+        const float scale = view.use_color ? 0.15f : 1.0f;
+        rgb[0] = (std::sin(float(i) * 0.1f) * 0.5f + 0.5f) * scale;
+        rgb[1] = (std::cos(float(i) * 0.1f) * 0.5f + 0.5f) * scale;
+        rgb[2] = scale;
+    }
+    else if (view.use_color) {
+        rgb[0] = std::sin(std::abs(sumx) / float(n) * 5.0f) * 0.45f + 0.5f;
+        rgb[1] = std::sin(std::abs(sumy) / float(n) * 5.0f) * 0.45f + 0.5f;
+        rgb[2] = std::sin(std::abs(sumz) / float(n) * 5.0f) * 0.45f + 0.5f;
+    }
+    else {
+        rgb[0] = rgb[1] = rgb[2] = 0.0f;
+    }
+}
+
+void EscapeTimeRenderer::pixelToPoint(const FractalView& view, float px, float py, float& x, float& y) {
+    x = (px - float(view.width) * 0.5f) / view.cam_zoom - view.cam_x;
+    y = (py - float(view.height) * 0.5f) / view.cam_zoom - view.cam_y;
+}
+
+void EscapeTimeRenderer::renderRect(const FractalView& view, int x0, int y0, int x1, int y1, juce::uint8* rgb, float* escape) {
+    const bool skipInterior = (view.type == 0 && !view.use_color && !view.julia);
+
+    const bool drawn = visitMap(view.type, view.formula.get(), [&](const auto& map) {
+        for (int py = y0; py < y1; ++py) {
+            juce::uint8* rgbRow = rgb + size_t(py - y0) * view.width * 3;
+            float* escapeRow = (escape != nullptr ? escape + size_t(py - y0) * view.width : nullptr);
+
+            for (int px = x0; px < x1; ++px) {
+                float x, y;
+                pixelToPoint(view, float(px) + 0.5f, float(py) + 0.5f, x, y);
+
+                float col[3] = { 0.0f, 0.0f, 0.0f };
+                float e = float(view.iters);
+                if (view.julia) {
+                    shade(view, map, x, y, view.jx, view.jy, col, e);
+                }
+                else if (!skipInterior || !mandelbrot_interior(x, y)) {
+                    shade(view, map, x, y, x, y, col, e);
+                }
+
+                const int i = px - x0;
+                for (int k = 0; k < 3; ++k) {
+                    rgbRow[i * 3 + k] = (juce::uint8)juce::roundToInt(juce::jlimit(0.0f, 1.0f, col[k]) * 255.0f);
+                }
+                if (escapeRow != nullptr) {
+                    escapeRow[i] = e;
+                }
+            }
+        }
+    });
+
+    if (!drawn) {
+        for (int py = y0; py < y1; ++py) {
+            std::fill_n(rgb + size_t(py - y0) * view.width * 3, size_t(x1 - x0) * 3, juce::uint8(0));
+            if (escape != nullptr) {
+                std::fill_n(escape + size_t(py - y0) * view.width, x1 - x0, float(view.iters));
+            }
+        }
+    }
+}
@@ -0,0 +1,45 @@
+/*
+  ==============================================================================
+
+    EscapeTimeRenderer.h
+    Created: 19 Oct 2026 3:32:09pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../Data/FractalMaps.h"
+#include "../Data/FormulaMap.h"
+
+// Everything needed to reproduce what the fractal view shows, at any resolution.
+struct FractalView {
+    int type = 0;
+    float cam_x = 0.0f;
+    float cam_y = 0.0f;
+    float cam_zoom = 100.0f; // Pixels per unit at width x height
+    bool julia = false;
+    float jx = 0.0f;
+    float jy = 0.0f;
+    bool use_color = false;
+    int iters = max_iters;
+    int width = 0;
+    int height = 0;
+    // The map when type is FormulaMap::custom_fractal
+    std::shared_ptr<const FormulaMap> formula;
+
+    // Same framing at a different pixel size
+    FractalView scaledTo(int newWidth, int newHeight) const;
+};
+
+// CPU version of the fragment shader's fractal() colouring, so offline renders
+// match the live view. Pixel (0, 0) is the top left corner.
+namespace EscapeTimeRenderer {
+    // Renders pixels [x0, x1) x [y0, y1). rgb (3 bytes per pixel) and escape (iterations
+    // per pixel, may be null) point at pixel (x0, y0) and have a row stride of view.width.
+    void renderRect(const FractalView& view, int x0, int y0, int x1, int y1, juce::uint8* rgb, float* escape);
+
+    void pixelToPoint(const FractalView& view, float px, float py, float& x, float& y);
+}
@@ -0,0 +1,296 @@
+/*
+  ==============================================================================
+
+    JuliaAtlas.cpp
+    Created: 25 Oct 2026 4:05:33pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#include "JuliaAtlas.h"
+#include "../Data/PerfTrace.h"
+
+JuliaAtlas::JuliaAtlas()
+{
+    directory = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("Phractal")
+        .getChildFile("JuliaAtlas");
+}
+
+JuliaAtlas::~JuliaAtlas()
+{
+    stop();
+    alive.cancelAndWait();
+    save();
+}
+
+void JuliaAtlas::start()
+{
+    const juce::ScopedLock sl(lock);
+    if (running) {
+        return;
+    }
+    running = true;
+    lifetime = alive.child();
+    // Whatever was queued when it stopped was dropped
+    tileQueued = false;
+    scheduleTile();
+}
+
+void JuliaAtlas::stop()
+{
+    const juce::ScopedLock sl(lock);
+    if (!running) {
+        return;
+    }
+    running = false;
+    // A tile still running stores into the atlas, but queues no next one
+    lifetime.cancel();
+}
+
+juce::File JuliaAtlas::getFile(int type) const
+{
+    return directory.getChildFile(juce::String(fractal_names[type]) + "_v" + juce::String(atlas_version) + ".png");
+}
+
+void JuliaAtlas::setType(int type)
+{
+    const juce::ScopedLock sl(lock);
+    if (type == requestedType) {
+        return;
+    }
+    requestedType = type;
+    jobs->submit(JobSystem::interactive, alive, [this, type] {
+        switchType(type);
+    });
+}
+
+void JuliaAtlas::switchType(int type)
+{
+    // Switching straight back may load the file from before this save, the tiles
+    // it misses are simply computed again
+    save();
+
+    // Read outside the lock, the GL thread keeps drawing the old atlas meanwhile
+    std::vector<juce::PixelARGB> loaded(size_t(atlas_size) * atlas_size, juce::PixelARGB(0, 0, 0, 0));
+    if (hasJulia(type)) {
+        const auto image = juce::ImageFileFormat::loadFrom(getFile(type));
+        if (image.getWidth() == atlas_size && image.getHeight() == atlas_size) {
+            const juce::Image::BitmapData data(image, juce::Image::BitmapData::readOnly);
+            for (int y = 0; y < atlas_size; ++y) {
+                for (int x = 0; x < atlas_size; ++x) {
+                    const auto colour = data.getPixelColour(x, y);
+                    loaded[size_t(y) * atlas_size + x] = juce::PixelARGB(colour.getAlpha(), colour.getRed(), colour.getGreen(), colour.getBlue());
+                }
+            }
+        }
+    }
+
+    const juce::ScopedLock sl(lock);
+    // A later switch is queued behind this one and does the work again
+    if (type != requestedType) {
+        return;
+    }
+    atlasType = type;
+    pixels = std::move(loaded);
+    done.assign(size_t(grid_size) * grid_size, false);
+    numDone = 0;
+    // A tile counts as done once its first pixel is opaque
+    for (int i = 0; i < grid_size * grid_size; ++i) {
+        const int x = (i % grid_size) * tile_size;
+        const int y = (i / grid_size) * tile_size;
+        if (pixels[size_t(y) * atlas_size + x].getAlpha() != 0) {
+            done[size_t(i)] = true;
+            ++numDone;
+        }
+    }
+    unsaved = 0;
+    wholeDirty = true;
+    dirtyTiles.clear();
+    scheduleTile();
+}
+
+int JuliaAtlas::nearestTile(float cx, float cy) const
+{
+    const float scale = float(grid_size - 1) / (c_max - c_min);
+    const int i = juce::jlimit(0, grid_size - 1, juce::roundToInt((cx - c_min) * scale));
+    const int j = juce::jlimit(0, grid_size - 1, juce::roundToInt((cy - c_min) * scale));
+    return j * grid_size + i;
+}
+
+void JuliaAtlas::setFocus(float cx, float cy)
+{
+    const juce::ScopedLock sl(lock);
+    focus = nearestTile(cx, cy);
+}
+
+bool JuliaAtlas::findTile(float cx, float cy, juce::Rectangle<float>& area) const
+{
+    const juce::ScopedLock sl(lock);
+    const int index = nearestTile(cx, cy);
+    if (!hasJulia(atlasType) || atlasType != requestedType || !done[size_t(index)]) {
+        return false;
+    }
+    const float size = float(tile_size) / float(atlas_size);
+    area = { float(index % grid_size) * size, float(index / grid_size) * size, size, size };
+    return true;
+}
+
+bool JuliaAtlas::takeUpdate(Update& update, bool wantWhole)
+{
+    const juce::ScopedLock sl(lock);
+    if (!hasJulia(atlasType) || atlasType != requestedType) {
+        return false;
+    }
+
+    update.whole = wantWhole || wholeDirty;
+    update.tiles.clear();
+    if (update.whole) {
+        update.pixels = pixels;
+    }
+    else {
+        if (dirtyTiles.empty()) {
+            return false;
+        }
+        update.tiles.swap(dirtyTiles);
+        update.pixels.resize(update.tiles.size() * tile_size * tile_size);
+        auto* dst = update.pixels.data();
+        for (const int index : update.tiles) {
+            const int x0 = (index % grid_size) * tile_size;
+            const int y0 = (index / grid_size) * tile_size;
+            for (int y = 0; y < tile_size; ++y) {
+                std::copy_n(pixels.data() + size_t(y0 + y) * atlas_size + x0, tile_size, dst);
+                dst += tile_size;
+            }
+        }
+    }
+    wholeDirty = false;
+    dirtyTiles.clear();
+    return true;
+}
+
+void JuliaAtlas::renderTile(int type, int index, std::vector<juce::uint8>& rgb) const
+{
+    // The tile shows z from c_min to c_max, like the c grid
+    FractalView view;
+    view.type = type;
+    view.julia = true;
+    view.jx = c_min + float(index % grid_size) * (c_max - c_min) / float(grid_size - 1);
+    view.jy = c_min + float(index / grid_size) * (c_max - c_min) / float(grid_size - 1);
+    view.cam_zoom = float(tile_size) / (c_max - c_min);
+    view.iters = tile_iters;
+    view.width = tile_size;
+    view.height = tile_size;
+
+    rgb.resize(size_t(tile_size) * tile_size * 3);
+    EscapeTimeRenderer::renderRect(view, 0, 0, tile_size, tile_size, rgb.data(), nullptr);
+}
+
+void JuliaAtlas::scheduleTile()
+{
+    if (!running || tileQueued || !hasJulia(atlasType) || atlasType != requestedType || numDone == grid_size * grid_size) {
+        return;
+    }
+
+    // One tile at a time, so the next one is always the missing tile nearest the
+    // focus as it is then, not as it was when a batch was queued
+    const int fx = focus % grid_size;
+    const int fy = focus / grid_size;
+    int best = std::numeric_limits<int>::max();
+    int index = -1;
+    for (int i = 0; i < grid_size * grid_size; ++i) {
+        if (!done[size_t(i)]) {
+            const int dx = i % grid_size - fx;
+            const int dy = i / grid_size - fy;
+            if (dx * dx + dy * dy < best) {
+                best = dx * dx + dy * dy;
+                index = i;
+            }
+        }
+    }
+
+    tileQueued = true;
+    jobs->submit(JobSystem::background, lifetime, [this, token = lifetime, type = atlasType, index] {
+        computeTile(token, type, index);
+    });
+}
+
+void JuliaAtlas::computeTile(const JobSystem::CancellationToken& token, int type, int index)
+{
+    std::vector<juce::uint8> rgb;
+    {
+        PHRACTAL_TRACE_SCOPE("Julia tile");
+        renderTile(type, index, rgb);
+    }
+
+    bool saveNow = false;
+    {
+        const juce::ScopedLock sl(lock);
+        // Dropped if the map changed while it rendered
+        if (type == atlasType && !done[size_t(index)]) {
+            const int x0 = (index % grid_size) * tile_size;
+            const int y0 = (index / grid_size) * tile_size;
+            for (int y = 0; y < tile_size; ++y) {
+                for (int x = 0; x < tile_size; ++x) {
+                    const juce::uint8* p = rgb.data() + (size_t(y) * tile_size + x) * 3;
+                    pixels[size_t(y0 + y) * atlas_size + x0 + x] = juce::PixelARGB(255, p[0], p[1], p[2]);
+                }
+            }
+            done[size_t(index)] = true;
+            ++numDone;
+            dirtyTiles.push_back(index);
+            saveNow = (++unsaved >= save_interval || numDone == grid_size * grid_size);
+        }
+        // After a stop the atlas may have been started again, with a tile of its own queued
+        if (!token.isCancelled()) {
+            tileQueued = false;
+            scheduleTile();
+        }
+    }
+    if (saveNow) {
+        save();
+    }
+}
+
+void JuliaAtlas::save()
+{
+    juce::Image image;
+    juce::File file;
+    if (takeSnapshot(image, file)) {
+        write(image, file);
+    }
+}
+
+bool JuliaAtlas::takeSnapshot(juce::Image& image, juce::File& file)
+{
+    const juce::ScopedLock sl(lock);
+    if (!hasJulia(atlasType) || unsaved == 0) {
+        return false;
+    }
+    unsaved = 0;
+    file = getFile(atlasType);
+    image = juce::Image(juce::Image::ARGB, atlas_size, atlas_size, true);
+    const juce::Image::BitmapData data(image, juce::Image::BitmapData::writeOnly);
+    for (int y = 0; y < atlas_size; ++y) {
+        for (int x = 0; x < atlas_size; ++x) {
+            const auto& p = pixels[size_t(y) * atlas_size + x];
+            data.setPixelColour(x, y, juce::Colour(p.getRed(), p.getGreen(), p.getBlue(), p.getAlpha()));
+        }
+    }
+    return true;
+}
+
+void JuliaAtlas::write(const juce::Image& image, const juce::File& file)
+{
+    // Written next to the file and moved over it, so a crash never leaves half an atlas
+    file.getParentDirectory().createDirectory();
+    juce::TemporaryFile temp(file);
+    {
+        juce::FileOutputStream out(temp.getFile());
+        if (!out.openedOk() || !juce::PNGImageFormat().writeImageToStream(image, out)) {
+            return;
+        }
+    }
+    temp.overwriteTargetFileWithTemporary();
+}
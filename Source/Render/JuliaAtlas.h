@@ -0,0 +1,107 @@
+/*
+  ==============================================================================
+
+    JuliaAtlas.h
+    Created: 25 Oct 2026 4:05:33pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "EscapeTimeRenderer.h"
+#include "../Data/JobSystem.h"
+
+// Low resolution Julia sets over a grid of c values, packed into one image so
+// the fractal view can show the one nearest the mouse without rendering it.
+// Background jobs on the shared pool fill in the missing tiles, always the one
+// nearest the focus next, so the tiles around the cursor are there first. Every
+// map has its own atlas, saved as a PNG (missing tiles transparent) and loaded
+// again the next time the map is picked. Saving and loading run on the pool
+// too, so every call here is cheap enough for the GL thread.
+class JuliaAtlas {
+public:
+    JuliaAtlas();
+    ~JuliaAtlas();
+
+    void start();
+    // Doesn't wait for a tile that is being computed, that finishes on its own
+    void stop();
+    bool isRunning() const { return running; }
+
+    // Switches to the atlas of the map, saving the previous one. The atlas is
+    // loaded in the background, until then no tile is found.
+    void setType(int type);
+    // The missing tile nearest c is computed next
+    void setFocus(float cx, float cy);
+
+    // Area of the tile nearest c, in atlas texture coordinates with row 0 at the
+    // top. False if that tile isn't computed yet.
+    bool findTile(float cx, float cy, juce::Rectangle<float>& area) const;
+
+    // What changed since the last update, for the texture
+    struct Update {
+        // The whole atlas, atlas_size pixels square, after a switch of map
+        bool whole = false;
+        // Otherwise the tiles added, tile_size pixels square each, in the order of tiles
+        std::vector<int> tiles;
+        std::vector<juce::PixelARGB> pixels;
+    };
+    // False if nothing changed. wantWhole asks for the whole atlas, e.g. for a new texture.
+    bool takeUpdate(Update& update, bool wantWhole);
+
+    static bool hasJulia(int type) { return type >= 0 && type < fractal_henon; }
+
+    static const int grid_size = 64;
+    static const int tile_size = 24;
+    static const int atlas_size = grid_size * tile_size;
+    static const int tile_iters = 256;
+    // c from c_min to c_max on both axes
+    static constexpr float c_min = -2.0f;
+    static constexpr float c_max = 2.0f;
+    // Tiles between saves while the atlas fills
+    static const int save_interval = 256;
+    // Bump when a kernel or the colouring changes, so old atlases aren't loaded
+    static const int atlas_version = 1;
+private:
+    // Queues the missing tile nearest the focus, unless one is queued already.
+    // Called with the lock held.
+    void scheduleTile();
+    void computeTile(const JobSystem::CancellationToken& token, int type, int index);
+    // Saves the current atlas and loads the one of type, unless another was asked for since
+    void switchType(int type);
+    void renderTile(int type, int index, std::vector<juce::uint8>& rgb) const;
+    void save();
+    // Copies the atlas into an image, false if no tile was added since the last save
+    bool takeSnapshot(juce::Image& image, juce::File& file);
+    static void write(const juce::Image& image, const juce::File& file);
+    juce::File getFile(int type) const;
+    int nearestTile(float cx, float cy) const;
+
+    mutable juce::CriticalSection lock;
+    int atlasType = -1;
+    // The map last asked for, atlasType once its atlas is loaded
+    int requestedType = -1;
+    std::vector<juce::PixelARGB> pixels;
+    std::vector<bool> done;
+    int numDone = 0;
+    int focus = 0;
+    // Changes the texture hasn't had yet
+    bool wholeDirty = false;
+    std::vector<int> dirtyTiles;
+    int unsaved = 0;
+
+    juce::File directory;
+
+    std::atomic<bool> running { false };
+    bool tileQueued = false;
+    juce::SharedResourcePointer<JobSystem> jobs;
+    // Parent of every job, waited on by the destructor so none outlives the atlas
+    JobSystem::CancellationToken alive;
+    // The tiles of one start to stop
+    JobSystem::CancellationToken lifetime = alive.child();
+
+    JUCE_DECLARE_NON_COPYABLE (JuliaAtlas)
+};
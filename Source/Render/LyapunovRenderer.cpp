@@ -0,0 +1,304 @@
+/*
+  ==============================================================================
+
+    LyapunovRenderer.cpp
+    Created: 25 Oct 2026 10:48:19am
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#include "LyapunovRenderer.h"
+#include "../Data/PerfTrace.h"
+
+// The image is recoloured at most this often while it refines
+static const double colour_interval_ms = 100.0;
+
+namespace {
+    // N orbits side by side. Every operation is a fixed-length loop over the
+    // lanes, which the compiler turns into vector instructions.
+    template <int N>
+    struct Lanes {
+        float v[N];
+
+        Lanes() = default;
+        explicit Lanes(double s) { std::fill_n(v, N, float(s)); }
+    };
+
+    template <int N> inline Lanes<N> operator+(const Lanes<N>& a, const Lanes<N>& b) { Lanes<N> r; for (int i = 0; i < N; ++i) r.v[i] = a.v[i] + b.v[i]; return r; }
+    template <int N> inline Lanes<N> operator-(const Lanes<N>& a, const Lanes<N>& b) { Lanes<N> r; for (int i = 0; i < N; ++i) r.v[i] = a.v[i] - b.v[i]; return r; }
+    template <int N> inline Lanes<N> operator*(const Lanes<N>& a, const Lanes<N>& b) { Lanes<N> r; for (int i = 0; i < N; ++i) r.v[i] = a.v[i] * b.v[i]; return r; }
+    template <int N> inline Lanes<N> operator/(const Lanes<N>& a, const Lanes<N>& b) { Lanes<N> r; for (int i = 0; i < N; ++i) r.v[i] = a.v[i] / b.v[i]; return r; }
+    template <int N> inline Lanes<N> operator-(const Lanes<N>& a) { Lanes<N> r; for (int i = 0; i < N; ++i) r.v[i] = -a.v[i]; return r; }
+    template <int N> inline Lanes<N> abs(const Lanes<N>& a) { Lanes<N> r; for (int i = 0; i < N; ++i) r.v[i] = std::abs(a.v[i]); return r; }
+    template <int N> inline Lanes<N> sign(const Lanes<N>& a) { Lanes<N> r; for (int i = 0; i < N; ++i) r.v[i] = (a.v[i] > 0.0f) - (a.v[i] < 0.0f); return r; }
+    template <int N> inline Lanes<N> sin(const Lanes<N>& a) { Lanes<N> r; for (int i = 0; i < N; ++i) r.v[i] = ph_sin(a.v[i]); return r; }
+    template <int N> inline Lanes<N> cos(const Lanes<N>& a) { Lanes<N> r; for (int i = 0; i < N; ++i) r.v[i] = ph_cos(a.v[i]); return r; }
+
+    // Dual number: a value and its derivative along the tangent vector. Running a
+    // map kernel on these moves the tangent vector by the map's Jacobian at the
+    // same time as the point, with no derivative written out per map.
+    template <typename V>
+    struct Tangent {
+        V val, d;
+
+        Tangent() = default;
+        explicit Tangent(double s) : val(s), d(0.0) {}
+        Tangent(const V& value, const V& derivative) : val(value), d(derivative) {}
+
+        Tangent& operator+=(const Tangent& o) { val = val + o.val; d = d + o.d; return *this; }
+    };
+
+    template <typename V> inline Tangent<V> operator+(const Tangent<V>& a, const Tangent<V>& b) { return { a.val + b.val, a.d + b.d }; }
+    template <typename V> inline Tangent<V> operator-(const Tangent<V>& a, const Tangent<V>& b) { return { a.val - b.val, a.d - b.d }; }
+    template <typename V> inline Tangent<V> operator*(const Tangent<V>& a, const Tangent<V>& b) { return { a.val * b.val, a.d * b.val + a.val * b.d }; }
+    template <typename V> inline Tangent<V> operator/(const Tangent<V>& a, const Tangent<V>& b) { return { a.val / b.val, (a.d * b.val - a.val * b.d) / (b.val * b.val) }; }
+    template <typename V> inline Tangent<V> operator-(const Tangent<V>& a) { return { -a.val, -a.d }; }
+    template <typename V> inline Tangent<V> abs(const Tangent<V>& a) { return { abs(a.val), a.d * sign(a.val) }; }
+    template <typename V> inline Tangent<V> sin(const Tangent<V>& a) { return { sin(a.val), cos(a.val) * a.d }; }
+    template <typename V> inline Tangent<V> cos(const Tangent<V>& a) { return { cos(a.val), -(sin(a.val) * a.d) }; }
+}
+
+template <typename Map>
+void LyapunovRenderer::computeExponents(const Map& map, const float* cx, const float* cy, float* out)
+{
+    using V = Lanes<lanes>;
+    using T = Tangent<V>;
+
+    T x(start_x), y(start_y);
+    x.d = V(1.0);
+    T tcx, tcy;
+    std::copy_n(cx, lanes, tcx.val.v);
+    std::copy_n(cy, lanes, tcy.val.v);
+    tcx.d = tcy.d = V(0.0);
+
+    float sum[lanes] = {};
+    bool escaped[lanes] = {};
+    for (int k = renormalise_interval; k <= orbit_transient + orbit_length; k += renormalise_interval) {
+        for (int s = 0; s < renormalise_interval; ++s) {
+            map(x, y, tcx, tcy);
+        }
+
+        int numEscaped = 0;
+        for (int l = 0; l < lanes; ++l) {
+            const float r = x.val.v[l] * x.val.v[l] + y.val.v[l] * y.val.v[l];
+            escaped[l] = escaped[l] || !(r <= escape_radius_sq);
+            numEscaped += escaped[l] ? 1 : 0;
+
+            const float n = std::sqrt(x.d.v[l] * x.d.v[l] + y.d.v[l] * y.d.v[l]);
+            if (k > orbit_transient) {
+                sum[l] += std::log(juce::jmax(n, 1e-30f));
+            }
+            if (n > 0.0f && std::isfinite(n)) {
+                x.d.v[l] /= n;
+                y.d.v[l] /= n;
+            }
+            else {
+                // Collapsed or blew up, start the direction over
+                x.d.v[l] = 1.0f;
+                y.d.v[l] = 0.0f;
+            }
+        }
+        if (numEscaped == lanes) {
+            break;
+        }
+    }
+
+    for (int l = 0; l < lanes; ++l) {
+        out[l] = escaped[l] ? std::numeric_limits<float>::quiet_NaN() : sum[l] / float(orbit_length);
+    }
+}
+
+// Exponents of the row's block anchors that the coarser passes haven't done
+void LyapunovRenderer::computeRow(const FractalView& v, int block, int row, std::vector<float>& values)
+{
+    const int numAnchors = (v.width + block - 1) / block;
+    values.assign(size_t(numAnchors), 0.0f);
+
+    std::vector<int> anchors;
+    const bool rowDone = (block < coarsest_block && row % (2 * block) == 0);
+    for (int i = 0; i < numAnchors; ++i) {
+        if (!rowDone || (i * block) % (2 * block) != 0) {
+            anchors.push_back(i);
+        }
+    }
+
+    for (size_t first = 0; first < anchors.size(); first += lanes) {
+        float cx[lanes], cy[lanes], out[lanes];
+        for (int l = 0; l < lanes; ++l) {
+            // Spare lanes repeat the last pixel
+            const int i = anchors[juce::jmin(first + l, anchors.size() - 1)];
+            EscapeTimeRenderer::pixelToPoint(v, float(i * block) + 0.5f, float(row) + 0.5f, cx[l], cy[l]);
+        }
+        visitFractal(v.type, [&](const auto& map) {
+            computeExponents(map, cx, cy, out);
+        });
+        for (size_t l = 0; l < lanes && first + l < anchors.size(); ++l) {
+            values[size_t(anchors[first + l])] = out[l];
+        }
+    }
+}
+
+//==============================================================================
+LyapunovRenderer::LyapunovRenderer()
+{
+}
+
+LyapunovRenderer::~LyapunovRenderer()
+{
+    stop();
+}
+
+void LyapunovRenderer::start()
+{
+    const juce::ScopedLock sl(lock);
+    if (running) {
+        return;
+    }
+    running = true;
+    lifetime = {};
+    viewToken = lifetime.child();
+    if (hasView && !finished) {
+        // The pass that was cut off by stop, from the start
+        rowsDone = 0;
+        submitPass();
+    }
+}
+
+void LyapunovRenderer::stop()
+{
+    JobSystem::CancellationToken token;
+    {
+        const juce::ScopedLock sl(lock);
+        if (!running) {
+            return;
+        }
+        running = false;
+        token = lifetime;
+    }
+    // Outside the lock, the rows still running store into it
+    token.cancelAndWait();
+}
+
+bool LyapunovRenderer::isRefining() const
+{
+    const juce::ScopedLock sl(lock);
+    return running && hasView && !finished;
+}
+
+void LyapunovRenderer::setView(const FractalView& newView)
+{
+    const juce::ScopedLock sl(lock);
+    if (hasView && view.type == newView.type && view.width == newView.width && view.height == newView.height
+        && view.cam_x == newView.cam_x && view.cam_y == newView.cam_y && view.cam_zoom == newView.cam_zoom) {
+        return;
+    }
+
+    view = newView;
+    hasView = true;
+    exponents.assign(size_t(juce::jmax(0, view.width)) * juce::jmax(0, view.height), std::numeric_limits<float>::quiet_NaN());
+    block = coarsest_block;
+    rowsDone = 0;
+    rowsInPass = (juce::jmax(0, view.height) + block - 1) / block;
+    finished = (view.width <= 0 || view.height <= 0 || !hasExponent(view.type));
+    ++changes;
+    ++generation;
+
+    // Rows of the old view that haven't started are dropped
+    viewToken.cancel();
+    viewToken = lifetime.child();
+    if (running && !finished) {
+        submitPass();
+    }
+}
+
+void LyapunovRenderer::submitPass()
+{
+    // Every row of the pass goes in at once, the pool spreads them over the cores
+    for (int row = 0; row < view.height; row += block) {
+        jobs->submit(JobSystem::interactive, viewToken, [this, v = view, gen = generation, rowBlock = block, row] {
+            PHRACTAL_TRACE_SCOPE("Lyapunov row");
+            std::vector<float> values;
+            computeRow(v, rowBlock, row, values);
+            storeRow(gen, rowBlock, row, values.data());
+        });
+    }
+}
+
+void LyapunovRenderer::storeRow(int gen, int rowBlock, int row, const float* values)
+{
+    const juce::ScopedLock sl(lock);
+    // Rows of an outdated view are dropped
+    if (gen != generation) {
+        return;
+    }
+
+    const bool rowDone = (rowBlock < coarsest_block && row % (2 * rowBlock) == 0);
+    const int y1 = juce::jmin(row + rowBlock, view.height);
+    for (int x0 = 0, i = 0; x0 < view.width; x0 += rowBlock, ++i) {
+        if (rowDone && x0 % (2 * rowBlock) == 0) {
+            continue;
+        }
+        const int x1 = juce::jmin(x0 + rowBlock, view.width);
+        for (int y = row; y < y1; ++y) {
+            std::fill(exponents.begin() + (size_t(y) * view.width + x0), exponents.begin() + (size_t(y) * view.width + x1), values[i]);
+        }
+    }
+    ++changes;
+
+    // A pass only starts once the coarser one is finished, so its blocks never paint over finer ones
+    if (++rowsDone == rowsInPass) {
+        if (block == 1) {
+            finished = true;
+        }
+        else {
+            block /= 2;
+            rowsDone = 0;
+            rowsInPass = (view.height + block - 1) / block;
+            submitPass();
+        }
+    }
+}
+
+bool LyapunovRenderer::getImage(std::vector<juce::PixelARGB>& argb, int& width, int& height)
+{
+    const double now = juce::Time::getMillisecondCounterHiRes();
+    const juce::ScopedLock sl(lock);
+
+    if (!hasView || changes == colouredChanges) {
+        return false;
+    }
+    // Throttled while refining, the last pass goes out as soon as it's done
+    if (!finished && now - lastColourTime < colour_interval_ms) {
+        return false;
+    }
+    colouredChanges = changes;
+    lastColourTime = now;
+
+    width = view.width;
+    height = view.height;
+    argb.resize(exponents.size());
+
+    // Stable orbits in blue, chaos in yellow, both brighter further from zero
+    for (size_t i = 0; i < exponents.size(); ++i) {
+        const float e = exponents[i];
+        float r = 0.0f, g = 0.0f, b = 0.0f;
+        if (e < 0.0f) {
+            const float t = juce::jmin(1.0f, -e * 2.0f);
+            r = 0.1f * t;
+            g = 0.35f * t;
+            b = t;
+        }
+        else if (e > 0.0f) {
+            const float t = juce::jmin(1.0f, e * 4.0f);
+            r = t;
+            g = 0.85f * t;
+            b = 0.2f * t;
+        }
+        argb[i] = juce::PixelARGB(255,
+            (juce::uint8)juce::roundToInt(r * 255.0f),
+            (juce::uint8)juce::roundToInt(g * 255.0f),
+            (juce::uint8)juce::roundToInt(b * 255.0f));
+    }
+    return true;
+}
@@ -0,0 +1,92 @@
+/*
+  ==============================================================================
+
+    PosterExporter.cpp
+    Created: 19 Oct 2026 4:27:15pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#include "PosterExporter.h"
+#include "StreamingPngWriter.h"
+
+PosterExporter::PosterExporter(const FractalView& v, const juce::File& f, bool escapeData)
+    : juce::ThreadWithProgressWindow("Exporting " + f.getFileName(), true, true),
+      view(v), file(f), writeEscapeData(escapeData)
+{
+}
+
+void PosterExporter::run()
+{
+    // Only replace the target files once the whole image has been written
+    juce::TemporaryFile pngTemp(file);
+    juce::TemporaryFile escapeTemp(file.withFileExtension("f32"));
+
+    std::unique_ptr<juce::FileOutputStream> pngOut = pngTemp.getFile().createOutputStream();
+    std::unique_ptr<juce::FileOutputStream> escapeOut;
+    if (writeEscapeData) {
+        escapeOut = escapeTemp.getFile().createOutputStream();
+    }
+    if (pngOut == nullptr || (writeEscapeData && escapeOut == nullptr)) {
+        failed = true;
+        return;
+    }
+
+    rgb.resize(size_t(view.width) * band_rows * 3);
+    if (writeEscapeData) {
+        escape.resize(size_t(view.width) * band_rows);
+    }
+
+    StreamingPngWriter png(*pngOut, view.width, view.height);
+
+    for (int y0 = 0; y0 < view.height; y0 += band_rows) {
+        if (threadShouldExit()) {
+            return;
+        }
+
+        const int rows = juce::jmin(band_rows, view.height - y0);
+        renderBand(y0, rows);
+
+        if (!png.writeRows(rgb.data(), rows)) {
+            failed = true;
+            return;
+        }
+        if (escapeOut != nullptr && !escapeOut->write(escape.data(), sizeof(float) * size_t(view.width) * rows)) {
+            failed = true;
+            return;
+        }
+
+        setProgress(double(y0 + rows) / double(view.height));
+    }
+
+    failed = !png.finish();
+    pngOut.reset();
+    escapeOut.reset();
+
+    if (!failed) {
+        failed = !pngTemp.overwriteTargetFileWithTemporary()
+            || (writeEscapeData && !escapeTemp.overwriteTargetFileWithTemporary());
+    }
+}
+
+void PosterExporter::renderBand(int y0, int rows)
+{
+    const int numTiles = (view.width + tile_width - 1) / tile_width;
+    jobs->parallelFor(JobSystem::normal, numTiles, [this, y0, rows](int tile) {
+        const int x0 = tile * tile_width;
+        const int x1 = juce::jmin(x0 + tile_width, view.width);
+        EscapeTimeRenderer::renderRect(view, x0, y0, x1, y0 + rows,
+            rgb.data() + size_t(x0) * 3,
+            escape.empty() ? nullptr : escape.data() + x0);
+    });
+}
+
+void PosterExporter::threadComplete(bool userPressedCancel)
+{
+    if (failed && !userPressedCancel) {
+        juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon,
+            "Export failed", "Couldn't write " + file.getFullPathName());
+    }
+    delete this;
+}
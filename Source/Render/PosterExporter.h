@@ -0,0 +1,43 @@
+/*
+  ==============================================================================
+
+    PosterExporter.h
+    Created: 19 Oct 2026 4:27:15pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "EscapeTimeRenderer.h"
+#include "../Data/JobSystem.h"
+
+// Renders a view at poster resolution on the shared job pool and streams it into a PNG
+// band by band, optionally with the raw float32 escape counts next to it
+// (<name>.f32, row-major, width x height, native byte order). Memory use only
+// depends on the width of the image and band_rows.
+// Launch with launchThread(); the exporter deletes itself when it's done.
+class PosterExporter : public juce::ThreadWithProgressWindow {
+public:
+    PosterExporter(const FractalView& view, const juce::File& file, bool writeEscapeData);
+
+    void run() override;
+    void threadComplete(bool userPressedCancel) override;
+
+    static const int band_rows = 64;
+    static const int tile_width = 256;
+private:
+    void renderBand(int y0, int rows);
+
+    const FractalView view;
+    const juce::File file;
+    const bool writeEscapeData;
+    bool failed = false;
+
+    juce::SharedResourcePointer<JobSystem> jobs;
+
+    std::vector<juce::uint8> rgb;
+    std::vector<float> escape;
+};
@@ -0,0 +1,261 @@
+/*
+  ==============================================================================
+
+    RenderBenchmark.cpp
+    Created: 24 Oct 2026 3:12:47pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#include "RenderBenchmark.h"
+
+std::vector<RenderBenchmark::Case> RenderBenchmark::getCases()
+{
+    // The same framing for every map. Where a map has nothing at the Mandelbrot
+    // boundary the timing still exercises its kernel.
+    struct Reference {
+        const char* name;
+        float x, y;       // Centre
+        float span;       // Width of the view
+    };
+    static const Reference references[] = {
+        { "shallow", -0.5f, 0.0f, 4.0f },
+        { "boundary", -0.745f, 0.113f, 0.05f },
+        { "deep", -0.7436439f, 0.1318259f, 2e-4f },
+    };
+
+    std::vector<Case> cases;
+    for (int type = 0; type < num_fractals; ++type) {
+        for (const auto& reference : references) {
+            Case c;
+            c.name = juce::String(fractal_names[type]) + "_" + reference.name;
+            c.view.type = type;
+            c.view.cam_x = -reference.x;
+            c.view.cam_y = -reference.y;
+            c.view.cam_zoom = float(width) / reference.span;
+            c.view.width = width;
+            c.view.height = height;
+            cases.push_back(c);
+        }
+    }
+    return cases;
+}
+
+juce::File RenderBenchmark::getDefaultDirectory()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("Phractal").getChildFile("Benchmark");
+}
+
+RenderBenchmark::RenderBenchmark(const juce::File& referenceDirectory, const juce::File& outputDirectory, std::vector<GpuFrame> gpuFrames)
+    : juce::ThreadWithProgressWindow("Render benchmark", true, true),
+      reference(referenceDirectory),
+      // Never write into the reference, the candidates would replace the goldens
+      directory(outputDirectory == referenceDirectory ? outputDirectory.getChildFile("Run") : outputDirectory),
+      gpu(std::move(gpuFrames))
+{
+}
+
+std::map<juce::String, double> RenderBenchmark::readBaseline(const juce::File& file)
+{
+    std::map<juce::String, double> baseline;
+    for (const auto& line : juce::StringArray::fromLines(file.loadFileAsString())) {
+        const auto tokens = juce::StringArray::fromTokens(line, " ", {});
+        if (tokens.size() == 3) {
+            baseline[tokens[0] + " " + tokens[1]] = tokens[2].getDoubleValue();
+        }
+    }
+    return baseline;
+}
+
+void RenderBenchmark::run()
+{
+    directory.createDirectory();
+    reference.createDirectory();
+    const auto cases = getCases();
+    const auto baseline = readBaseline(reference.getChildFile("baseline.txt"));
+
+    std::vector<juce::uint8> rgb(size_t(width) * height * 3);
+    std::vector<float> escape(size_t(width) * height);
+    const double pixels = double(width) * height;
+
+    report.add("Reference: " + reference.getFullPathName());
+    report.add(juce::String("case").paddedRight(' ', 28) + "path   ms/frame   baseline   Mpixels/s   Miters/s   mismatch");
+    for (size_t k = 0; k < cases.size(); ++k) {
+        if (threadShouldExit()) {
+            return;
+        }
+        const auto& c = cases[k];
+        setStatusMessage(c.name);
+
+        double totalMs = 0.0;
+        for (int f = 0; f < frames_per_case; ++f) {
+            const double start = juce::Time::getMillisecondCounterHiRes();
+            jobs->parallelFor(JobSystem::normal, (height + band_rows - 1) / band_rows, [&](int band) {
+                const int y0 = band * band_rows;
+                const int y1 = juce::jmin(y0 + band_rows, height);
+                EscapeTimeRenderer::renderRect(c.view, 0, y0, width, y1,
+                    rgb.data() + size_t(y0) * width * 3, escape.data() + size_t(y0) * width);
+            });
+            totalMs += juce::Time::getMillisecondCounterHiRes() - start;
+        }
+
+        // Escape counts, with pixels that never escaped counted at the cap. The
+        // cycle exit stops those earlier, so this is an upper bound on the work.
+        double iterations = 0.0;
+        for (const float e : escape) {
+            iterations += e;
+        }
+
+        const auto goldenFile = reference.getChildFile(c.name + ".png");
+        std::vector<juce::uint8> golden;
+        if (goldenFile.existsAsFile()) {
+            golden = fromImage(juce::ImageFileFormat::loadFrom(goldenFile));
+        }
+        bool keepImage = false;
+
+        const auto addLine = [&](const char* path, double ms, const std::vector<juce::uint8>& image, double tolerance) {
+            const auto key = c.name + " " + path;
+            timings.add(key + " " + juce::String(ms, 3));
+
+            juce::String line = c.name.paddedRight(' ', 28) + juce::String(path).paddedRight(' ', 7)
+                + juce::String(ms, 2).paddedLeft(' ', 8);
+            const auto base = baseline.find(key);
+            const bool slower = base != baseline.end() && ms > base->second * timing_tolerance;
+            numSlower += slower ? 1 : 0;
+            line << (base != baseline.end() ? juce::String(base->second, 2) : juce::String("-")).paddedLeft(' ', 11)
+                 << juce::String(pixels / ms * 1e-3, 2).paddedLeft(' ', 12)
+                 << juce::String(iterations / ms * 1e-3, 1).paddedLeft(' ', 11);
+
+            if (golden.empty()) {
+                line << juce::String("-").paddedLeft(' ', 11) << "  NO GOLDEN, recorded";
+            }
+            else {
+                const double off = mismatch(image, golden);
+                const bool failed = off > tolerance;
+                numFailed += failed ? 1 : 0;
+                keepImage = keepImage || failed;
+                line << juce::String(off * 100.0, 2).paddedLeft(' ', 10) << "%" << (failed ? "  FAIL" : "");
+            }
+            report.add(line + (slower ? "  SLOWER" : ""));
+        };
+        addLine("cpu", totalMs / frames_per_case, rgb, cpu_tolerance);
+        if (k < gpu.size() && gpu[k].ms >= 0.0) {
+            addLine("glsl", gpu[k].ms, gpu[k].rgb, gpu_tolerance);
+        }
+
+        // The CPU image becomes the golden if there was none, and goes next to
+        // the report if it failed
+        const auto writeImage = [&rgb](const juce::File& imageFile) {
+            imageFile.deleteFile();
+            juce::FileOutputStream out(imageFile);
+            juce::PNGImageFormat().writeImageToStream(toImage(rgb), out);
+        };
+        if (golden.empty()) {
+            writeImage(goldenFile);
+            ++numRecorded;
+        }
+        if (keepImage) {
+            writeImage(directory.getChildFile(c.name + ".png"));
+        }
+
+        setProgress(double(k + 1) / double(cases.size()));
+    }
+
+    runSelfChecks();
+    directory.getChildFile("benchmark.txt").replaceWithText(report.joinIntoString("\n") + "\n");
+    directory.getChildFile("baseline.txt").replaceWithText(timings.joinIntoString("\n") + "\n");
+
+    const auto baselineFile = reference.getChildFile("baseline.txt");
+    if (!baselineFile.existsAsFile()) {
+        baselineFile.replaceWithText(timings.joinIntoString("\n") + "\n");
+        baselineRecorded = true;
+    }
+}
+
+void RenderBenchmark::runSelfChecks()
+{
+    setStatusMessage("Self checks");
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+    runner.runTestsInCategory("Phractal");
+
+    report.add({});
+    for (int i = 0; i < runner.getNumResults(); ++i) {
+        const auto* result = runner.getResult(i);
+        numFailed += result->failures;
+        report.add((result->unitTestName + ": " + result->subcategoryName).paddedRight(' ', 48)
+            + (result->failures > 0 ? "FAIL" : "ok"));
+        for (const auto& message : result->messages) {
+            report.add("    " + message);
+        }
+    }
+}
+
+double RenderBenchmark::mismatch(const std::vector<juce::uint8>& a, const std::vector<juce::uint8>& b)
+{
+    if (a.size() != b.size() || a.empty()) {
+        return 1.0;
+    }
+    size_t differing = 0;
+    for (size_t i = 0; i < a.size(); i += 3) {
+        for (size_t k = 0; k < 3; ++k) {
+            if (std::abs(int(a[i + k]) - int(b[i + k])) > channel_tolerance) {
+                ++differing;
+                break;
+            }
+        }
+    }
+    return double(differing) / double(a.size() / 3);
+}
+
+juce::Image RenderBenchmark::toImage(const std::vector<juce::uint8>& rgb)
+{
+    juce::Image image(juce::Image::RGB, width, height, false);
+    const juce::Image::BitmapData data(image, juce::Image::BitmapData::writeOnly);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const juce::uint8* p = rgb.data() + (size_t(y) * width + x) * 3;
+            data.setPixelColour(x, y, juce::Colour(p[0], p[1], p[2]));
+        }
+    }
+    return image;
+}
+
+std::vector<juce::uint8> RenderBenchmark::fromImage(const juce::Image& image)
+{
+    if (image.getWidth() != width || image.getHeight() != height) {
+        return {};
+    }
+    std::vector<juce::uint8> rgb(size_t(width) * height * 3);
+    const juce::Image::BitmapData data(image, juce::Image::BitmapData::readOnly);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const auto colour = data.getPixelColour(x, y);
+            juce::uint8* p = rgb.data() + (size_t(y) * width + x) * 3;
+            p[0] = colour.getRed();
+            p[1] = colour.getGreen();
+            p[2] = colour.getBlue();
+        }
+    }
+    return rgb;
+}
+
+void RenderBenchmark::threadComplete(bool userPressedCancel)
+{
+    if (!userPressedCancel) {
+        const auto reportFile = directory.getChildFile("benchmark.txt");
+        juce::String summary = juce::String(numFailed) + " of the images and self checks failed.";
+        summary << "\n" << numSlower << " timings are slower than the baseline.";
+        if (numRecorded > 0) {
+            summary << "\n" << numRecorded << " cases had no golden, this run's images were recorded as the reference.";
+        }
+        if (baselineRecorded) {
+            summary << "\nThere was no baseline, this run's timings were recorded as the reference.";
+        }
+        juce::AlertWindow::showMessageBoxAsync(numFailed + numSlower > 0 ? juce::MessageBoxIconType::WarningIcon : juce::MessageBoxIconType::InfoIcon,
+            "Render benchmark", summary + "\nFull report: " + reportFile.getFullPathName());
+    }
+    delete this;
+}
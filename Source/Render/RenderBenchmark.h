@@ -0,0 +1,92 @@
+/*
+  ==============================================================================
+
+    RenderBenchmark.h
+    Created: 24 Oct 2026 3:12:47pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <map>
+#include "EscapeTimeRenderer.h"
+#include "../Data/JobSystem.h"
+
+// Times the escape-time renderers on a fixed set of reference views, one set
+// per fractal type, and checks every image against a golden PNG and every
+// timing against a baseline, so changes to the shader or the map kernels can't
+// make them slower or wrong unnoticed.
+//
+// The reference folder is chosen when the benchmark starts, normally the one
+// versioned with the source. It holds a golden <case>.png per case and
+// baseline.txt, a "<case> <path> <ms>" line per timing. Nothing in it is ever
+// replaced: only a missing golden or a missing baseline.txt is written there,
+// from this run, so the first run on a machine records the reference.
+// The report, this run's timings in the same format and the images of cases
+// that failed go to the output folder; copying them into the reference folder
+// records a new reference.
+//
+// The GLSL frames are rendered by the fractal view on its GL thread first and
+// handed in; this thread then renders the same cases with EscapeTimeRenderer
+// on the shared job pool. The self checks (the unit tests in the "Phractal"
+// category) run after the cases.
+// Launch with launchThread(); the benchmark deletes itself when it's done.
+class RenderBenchmark : public juce::ThreadWithProgressWindow {
+public:
+    struct Case {
+        juce::String name;
+        FractalView view;
+    };
+
+    // One GLSL render per case, ms < 0 if it couldn't be rendered
+    struct GpuFrame {
+        double ms = -1.0;
+        std::vector<juce::uint8> rgb;
+    };
+
+    // Shallow, boundary-heavy and deep views for every built-in fractal type
+    static std::vector<Case> getCases();
+    // Where the report and the candidate images go
+    static juce::File getDefaultDirectory();
+
+    RenderBenchmark(const juce::File& referenceDirectory, const juce::File& outputDirectory, std::vector<GpuFrame> gpuFrames);
+
+    void run() override;
+    void threadComplete(bool userPressedCancel) override;
+
+    static const int width = 640;
+    static const int height = 360;
+    static const int frames_per_case = 3;
+    // A pixel matches when no channel is further off than this
+    static const int channel_tolerance = 8;
+    // Fraction of pixels allowed to differ. The GPU's float rounding differs
+    // from the CPU's, which flips pixels right on the boundary.
+    static constexpr double cpu_tolerance = 0.001;
+    static constexpr double gpu_tolerance = 0.02;
+    // A case is slower when it takes this much longer than its baseline
+    static constexpr double timing_tolerance = 1.25;
+    static const int band_rows = 32;
+private:
+    // The unit tests in the "Phractal" category, e.g. the FastTrig error bounds
+    void runSelfChecks();
+    // Baseline ms per "<case> <path>"
+    static std::map<juce::String, double> readBaseline(const juce::File& file);
+    static double mismatch(const std::vector<juce::uint8>& a, const std::vector<juce::uint8>& b);
+    static juce::Image toImage(const std::vector<juce::uint8>& rgb);
+    static std::vector<juce::uint8> fromImage(const juce::Image& image);
+
+    const juce::File reference;
+    const juce::File directory;
+    const std::vector<GpuFrame> gpu;
+    juce::StringArray report;
+    juce::StringArray timings;
+    int numFailed = 0;
+    int numSlower = 0;
+    int numRecorded = 0;
+    bool baselineRecorded = false;
+
+    juce::SharedResourcePointer<JobSystem> jobs;
+};
@@ -0,0 +1,127 @@
+/*
+  ==============================================================================
+
+    StreamingPngWriter.cpp
+    Created: 19 Oct 2026 3:58:44pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#include "StreamingPngWriter.h"
+
+static const size_t idat_chunk_size = 1 << 16;
+
+static juce::uint32 crc32(juce::uint32 crc, const juce::uint8* data, size_t size) {
+    static const auto table = [] {
+        std::array<juce::uint32, 256> t;
+        for (juce::uint32 n = 0; n < 256; ++n) {
+            juce::uint32 c = n;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xedb88320u ^ (c >> 1) : (c >> 1);
+            }
+            t[n] = c;
+        }
+        return t;
+    }();
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static void writeBigEndian(juce::uint8* dest, juce::uint32 value) {
+    dest[0] = (juce::uint8)(value >> 24);
+    dest[1] = (juce::uint8)(value >> 16);
+    dest[2] = (juce::uint8)(value >> 8);
+    dest[3] = (juce::uint8)value;
+}
+
+//==============================================================================
+StreamingPngWriter::StreamingPngWriter(juce::OutputStream& o, int w, int h)
+    : out(o), width(w), height(h)
+{
+    static const juce::uint8 signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    ok = out.write(signature, sizeof(signature));
+
+    juce::uint8 header[13];
+    writeBigEndian(header, (juce::uint32)width);
+    writeBigEndian(header + 4, (juce::uint32)height);
+    header[8] = 8;  // Bit depth
+    header[9] = 2;  // Colour type: RGB
+    header[10] = 0; // Deflate
+    header[11] = 0; // Adaptive filtering
+    header[12] = 0; // No interlace
+    writeChunk("IHDR", header, sizeof(header));
+
+    // Default window bits give a zlib stream, which is what IDAT expects
+    compressor = std::make_unique<juce::GZIPCompressorOutputStream>(compressed, 6);
+    filtered.malloc(size_t(width) * 3 + 1);
+}
+
+bool StreamingPngWriter::writeRows(const juce::uint8* rgb, int numRows)
+{
+    jassert(rowsWritten + numRows <= height);
+    const size_t rowBytes = size_t(width) * 3;
+
+    for (int r = 0; r < numRows && ok; ++r) {
+        const juce::uint8* row = rgb + r * rowBytes;
+
+        // Sub filter: each byte minus the same channel of the previous pixel
+        filtered[0] = 1;
+        for (size_t i = 0; i < rowBytes; ++i) {
+            filtered[i + 1] = (juce::uint8)(row[i] - (i >= 3 ? row[i - 3] : 0));
+        }
+        ok = compressor->write(filtered, rowBytes + 1);
+
+        if (compressed.getDataSize() >= idat_chunk_size) {
+            flushIdat();
+        }
+    }
+
+    rowsWritten += numRows;
+    return ok;
+}
+
+bool StreamingPngWriter::finish()
+{
+    jassert(rowsWritten == height);
+
+    // Ends the zlib stream
+    compressor->flush();
+    compressor.reset();
+    flushIdat();
+
+    writeChunk("IEND", nullptr, 0);
+    out.flush();
+    return ok;
+}
+
+void StreamingPngWriter::flushIdat()
+{
+    if (compressed.getDataSize() > 0) {
+        writeChunk("IDAT", compressed.getData(), compressed.getDataSize());
+        compressed.reset();
+    }
+}
+
+void StreamingPngWriter::writeChunk(const char* type, const void* data, size_t size)
+{
+    juce::uint8 length[4];
+    writeBigEndian(length, (juce::uint32)size);
+
+    auto crc = crc32(0, reinterpret_cast<const juce::uint8*>(type), 4);
+    if (size > 0) {
+        crc = crc32(crc, static_cast<const juce::uint8*>(data), size);
+    }
+    juce::uint8 crcBytes[4];
+    writeBigEndian(crcBytes, crc);
+
+    ok = ok
+        && out.write(length, 4)
+        && out.write(type, 4)
+        && (size == 0 || out.write(data, size))
+        && out.write(crcBytes, 4);
+}
@@ -0,0 +1,43 @@
+/*
+  ==============================================================================
+
+    StreamingPngWriter.h
+    Created: 19 Oct 2026 3:58:44pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Writes an 8-bit RGB PNG a few scanlines at a time, so images far bigger than
+// memory can be encoded. Compressed data is flushed into IDAT chunks as it is
+// produced; only the zlib window and one chunk are held at once.
+class StreamingPngWriter {
+public:
+    StreamingPngWriter(juce::OutputStream& out, int width, int height);
+
+    // rgb holds numRows tightly packed rows of width * 3 bytes.
+    bool writeRows(const juce::uint8* rgb, int numRows);
+
+    // Must be called once every row has been written.
+    bool finish();
+
+private:
+    void writeChunk(const char* type, const void* data, size_t size);
+    void flushIdat();
+
+    juce::OutputStream& out;
+    const int width;
+    const int height;
+    int rowsWritten = 0;
+    bool ok = true;
+
+    juce::MemoryOutputStream compressed;
+    std::unique_ptr<juce::GZIPCompressorOutputStream> compressor;
+    juce::HeapBlock<juce::uint8> filtered;
+
+    JUCE_DECLARE_NON_COPYABLE (StreamingPngWriter)
+};
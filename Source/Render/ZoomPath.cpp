@@ -0,0 +1,44 @@
+/*
+  ==============================================================================
+
+    ZoomPath.cpp
+    Created: 20 Oct 2026 2:14:37pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#include "ZoomPath.h"
+
+FractalView ZoomPath::at(double position) const {
+    jassert(!keyframes.empty());
+    position = juce::jlimit(0.0, double(keyframes.size() - 1), position);
+    const int k = juce::jmin(int(position), int(keyframes.size()) - 1);
+    if (k == int(keyframes.size()) - 1) {
+        return keyframes.back();
+    }
+
+    const FractalView& a = keyframes[k];
+    const FractalView b = keyframes[k + 1].scaledTo(a.width, a.height);
+    const double t = position - k;
+
+    FractalView view = a;
+    const double zoom = a.cam_zoom * std::pow(double(b.cam_zoom) / a.cam_zoom, t);
+    view.cam_zoom = float(zoom);
+
+    // Fraction of the way from 1/zoom_a to 1/zoom_b, so the centre keeps pace with the zoom
+    double s = t;
+    const double inv_a = 1.0 / a.cam_zoom;
+    const double inv_b = 1.0 / b.cam_zoom;
+    if (std::abs(inv_a - inv_b) > 1e-9 * inv_a) {
+        s = (inv_a - 1.0 / zoom) / (inv_a - inv_b);
+    }
+    view.cam_x = float(a.cam_x + (b.cam_x - a.cam_x) * s);
+    view.cam_y = float(a.cam_y + (b.cam_y - a.cam_y) * s);
+
+    if (a.julia && b.julia) {
+        view.jx = float(a.jx + (b.jx - a.jx) * t);
+        view.jy = float(a.jy + (b.jy - a.jy) * t);
+    }
+    return view;
+}
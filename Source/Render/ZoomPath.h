@@ -0,0 +1,32 @@
+/*
+  ==============================================================================
+
+    ZoomPath.h
+    Created: 20 Oct 2026 2:14:37pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "EscapeTimeRenderer.h"
+
+// Camera keyframes (centre, zoom, Julia point, fractal type) for offline zoom
+// renders. Positions run from 0 at the first keyframe to size() - 1 at the last.
+class ZoomPath {
+public:
+    void add(const FractalView& view) { keyframes.push_back(view); }
+    void clear() { keyframes.clear(); }
+    int size() const { return int(keyframes.size()); }
+    bool isEmpty() const { return keyframes.empty(); }
+
+    // Zoom is interpolated exponentially, and the centre so that it moves at a
+    // steady speed on screen while zooming. The fractal type, colour mode and
+    // Julia flag switch at the next keyframe.
+    FractalView at(double position) const;
+
+private:
+    std::vector<FractalView> keyframes;
+};
@@ -0,0 +1,134 @@
+/*
+  ==============================================================================
+
+    ZoomPathRenderer.cpp
+    Created: 20 Oct 2026 2:40:03pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#include "ZoomPathRenderer.h"
+#include "StreamingPngWriter.h"
+
+static bool sameView(const FractalView& a, const FractalView& b) {
+    return a.type == b.type && a.formula == b.formula && a.cam_x == b.cam_x && a.cam_y == b.cam_y && a.cam_zoom == b.cam_zoom
+        && a.julia == b.julia && (!a.julia || (a.jx == b.jx && a.jy == b.jy))
+        && a.use_color == b.use_color && a.iters == b.iters
+        && a.width == b.width && a.height == b.height;
+}
+
+ZoomPathRenderer::ZoomPathRenderer(const ZoomPath& p, const juce::File& f, int w, int h, bool raw)
+    : juce::ThreadWithProgressWindow("Rendering " + f.getFileName(), true, true),
+      path(p), file(f), width(w), height(h), rawVideo(raw)
+{
+}
+
+void ZoomPathRenderer::run()
+{
+    const int numFrames = juce::roundToInt((path.size() - 1) * seconds_per_keyframe * fps) + 1;
+
+    std::unique_ptr<juce::FileOutputStream> rawOut;
+    if (rawVideo) {
+        file.deleteFile();
+        rawOut = file.createOutputStream();
+        if (rawOut == nullptr) {
+            failed = true;
+            return;
+        }
+        file.withFileExtension("txt").replaceWithText(
+            "ffmpeg -f rawvideo -pix_fmt rgb24 -s " + juce::String(width) + "x" + juce::String(height)
+            + " -r " + juce::String(fps) + " -i \"" + file.getFileName() + "\" -pix_fmt yuv420p \""
+            + file.getFileNameWithoutExtension() + ".mp4\"\n");
+    }
+
+    for (auto& frame : frames) {
+        frame.rgb.resize(size_t(width) * height * 3);
+    }
+
+    FractalView previous;
+    bool hasPrevious = false;
+
+    for (int f0 = 0; f0 < numFrames; f0 += frames_in_flight) {
+        if (threadShouldExit()) {
+            return;
+        }
+
+        const int count = juce::jmin(frames_in_flight, numFrames - f0);
+
+        // Frames that repeat the one before them (held keyframes) are copied instead of rendered
+        for (int i = 0; i < count; ++i) {
+            Frame& frame = frames[i];
+            frame.view = path.at(double(f0 + i) / (seconds_per_keyframe * fps)).scaledTo(width, height);
+            frame.reused = hasPrevious && sameView(frame.view, previous);
+            previous = frame.view;
+            hasPrevious = true;
+            if (frame.reused && i == 0) {
+                // The last frame of the previous block, before this block renders over it
+                frame.rgb = frames[frames_in_flight - 1].rgb;
+            }
+        }
+
+        // Every band of every rendered frame in the block, as one batch
+        bands.clear();
+        for (int i = 0; i < count; ++i) {
+            if (frames[i].reused) {
+                continue;
+            }
+            for (int y0 = 0; y0 < height; y0 += band_rows) {
+                bands.push_back({ &frames[i], y0 });
+            }
+        }
+        jobs->parallelFor(JobSystem::normal, int(bands.size()), [this](int b) {
+            Frame& frame = *bands[size_t(b)].first;
+            const int y0 = bands[size_t(b)].second;
+            const int y1 = juce::jmin(y0 + band_rows, height);
+            EscapeTimeRenderer::renderRect(frame.view, 0, y0, width, y1,
+                frame.rgb.data() + size_t(y0) * width * 3, nullptr);
+        });
+
+        for (int i = 0; i < count; ++i) {
+            if (frames[i].reused && i > 0) {
+                frames[i].rgb = frames[i - 1].rgb;
+            }
+            if (!writeFrame(frames[i], f0 + i, rawOut.get())) {
+                failed = true;
+                return;
+            }
+        }
+
+        setProgress(double(f0 + count) / double(numFrames));
+    }
+
+    if (rawOut != nullptr) {
+        rawOut->flush();
+        failed = rawOut->getStatus().failed();
+    }
+}
+
+bool ZoomPathRenderer::writeFrame(const Frame& frame, int index, juce::OutputStream* rawOut)
+{
+    if (rawOut != nullptr) {
+        return rawOut->write(frame.rgb.data(), frame.rgb.size());
+    }
+
+    const auto frameFile = file.getSiblingFile(file.getFileNameWithoutExtension()
+        + "_" + juce::String(index).paddedLeft('0', 5) + ".png");
+    frameFile.deleteFile();
+    std::unique_ptr<juce::FileOutputStream> out = frameFile.createOutputStream();
+    if (out == nullptr) {
+        return false;
+    }
+
+    StreamingPngWriter png(*out, width, height);
+    return png.writeRows(frame.rgb.data(), height) && png.finish();
+}
+
+void ZoomPathRenderer::threadComplete(bool userPressedCancel)
+{
+    if (failed && !userPressedCancel) {
+        juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon,
+            "Render failed", "Couldn't write " + file.getFullPathName());
+    }
+    delete this;
+}
@@ -0,0 +1,56 @@
+/*
+  ==============================================================================
+
+    ZoomPathRenderer.h
+    Created: 20 Oct 2026 2:40:03pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ZoomPath.h"
+#include "../Data/JobSystem.h"
+
+// Renders a ZoomPath offline at a fixed resolution and frame rate, either as a
+// numbered PNG sequence (<name>_00000.png, ...) or as one raw rgb24 stream with
+// a <name>.txt next to it holding the ffmpeg command that encodes it.
+// A few frames are rendered at once, split into bands on the shared job pool, and
+// written out in order as soon as they are done, so only frames_in_flight
+// frames are ever held in memory.
+// Launch with launchThread(); the renderer deletes itself when it's done.
+class ZoomPathRenderer : public juce::ThreadWithProgressWindow {
+public:
+    ZoomPathRenderer(const ZoomPath& path, const juce::File& file, int width, int height, bool rawVideo);
+
+    void run() override;
+    void threadComplete(bool userPressedCancel) override;
+
+    static const int fps = 30;
+    static constexpr double seconds_per_keyframe = 4.0;
+    static const int frames_in_flight = 4;
+    static const int band_rows = 32;
+private:
+    struct Frame {
+        FractalView view;
+        std::vector<juce::uint8> rgb;
+        bool reused = false;
+    };
+
+    bool writeFrame(const Frame& frame, int index, juce::OutputStream* rawOut);
+
+    const ZoomPath path;
+    const juce::File file;
+    const int width;
+    const int height;
+    const bool rawVideo;
+    bool failed = false;
+
+    std::array<Frame, frames_in_flight> frames;
+    // Frame and first row of every band of the block being rendered
+    std::vector<std::pair<Frame*, int>> bands;
+
+    juce::SharedResourcePointer<JobSystem> jobs;
+};
@@ -0,0 +1,46 @@
+/*
+  ==============================================================================
+
+    ScheduledSynthesiser.cpp
+    Created: 22 Oct 2026 11:20:08am
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#include "ScheduledSynthesiser.h"
+#include "SynthVoice.h"
+#include "Data/PerfTrace.h"
+
+void ScheduledSynthesiser::renderBlock(juce::AudioBuffer<float>& outputAudio, const juce::MidiBuffer& midiData, int numSamples) {
+    PHRACTAL_TRACE_SCOPE("Synthesiser::renderBlock");
+    const juce::ScopedLock sl(lock);
+
+    // Voice allocation still happens here in event order, only the rendering is deferred.
+    // Every voice is stamped before the first event, whatever the last block left behind.
+    int eventSample = -1;
+    for (const auto metadata : midiData) {
+        const int sample = juce::jlimit(0, juce::jmax(0, numSamples - 1), metadata.samplePosition);
+        if (sample != eventSample) {
+            eventSample = sample;
+            for (auto* voice : voices) {
+                if (auto* synthVoice = dynamic_cast<SynthVoice*>(voice)) {
+                    synthVoice->setEventSample(eventSample);
+                }
+            }
+        }
+        handleMidiEvent(metadata.getMessage());
+    }
+
+    PHRACTAL_TRACE_SCOPE("renderVoices");
+    renderVoices(outputAudio, 0, numSamples);
+}
+
+bool ScheduledSynthesiser::isSounding() const {
+    for (auto* voice : voices) {
+        if (voice->isVoiceActive()) {
+            return true;
+        }
+    }
+    return false;
+}
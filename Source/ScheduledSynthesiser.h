@@ -0,0 +1,27 @@
+/*
+  ==============================================================================
+
+    ScheduledSynthesiser.h
+    Created: 22 Oct 2026 11:20:08am
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// juce::Synthesiser splits the block at every MIDI event and renders every voice
+// once per piece, so a dense CC stream or an arpeggio turns one block into dozens
+// of tiny ones, each paying for the whole voice setup again. This one dispatches
+// all of the block's events up front, with the voices queueing them stamped with
+// their sample position, then renders every voice once over the whole block.
+// Voices only split their own rendering where one of their notes starts or stops.
+class ScheduledSynthesiser : public juce::Synthesiser {
+public:
+    void renderBlock(juce::AudioBuffer<float>& outputAudio, const juce::MidiBuffer& midiData, int numSamples);
+
+    // True while any voice is playing or releasing a note.
+    bool isSounding() const;
+};
@@ -15,39 +15,122 @@ bool SynthVoice::canPlaySound(juce::SynthesiserSound* sound) {
 }
 
 void SynthVoice::startNote(int midiNoteNumber, float velocity, juce::SynthesiserSound* sound, int currentPitchWheelPosition) {
-    osc1.setWaveFrequency(midiNoteNumber);
-    osc2.setWaveFrequency(midiNoteNumber);
-    adsr.noteOn();
+    queueEvent(VoiceEvent::Type::pitchWheel, currentPitchWheelPosition, 0.0f);
+    queueEvent(VoiceEvent::Type::noteOn, midiNoteNumber, velocity);
 }
 
 void SynthVoice::stopNote(float velocity, bool allowTailOff) {
-    adsr.noteOff();
+    queueEvent(allowTailOff ? VoiceEvent::Type::noteOff : VoiceEvent::Type::stop, 0, velocity);
 
-    if (!allowTailOff || !adsr.isActive()) {
+    // The synthesiser may hand this voice a new note straight away, the old one
+    // still plays up to the stop when the block is rendered
+    if (!allowTailOff) {
         clearCurrentNote();
     }
 }
 
 void SynthVoice::pitchWheelMoved(int newPitchWheelValue) {
+    queueEvent(VoiceEvent::Type::pitchWheel, newPitchWheelValue, 0.0f);
+}
+
+void SynthVoice::queueEvent(VoiceEvent::Type type, int value, float velocity) {
+    // Storage is reserved in prepareToPlay, running out means a flood of events
+    // for this one voice. The newest event then replaces the last one of its kind,
+    // only the latest wheel position and note state matter. It's moved to the end
+    // so the queue stays in sample order, and removing never frees storage.
+    if (events.size() >= max_events) {
+        const bool wheel = (type == VoiceEvent::Type::pitchWheel);
+        int replaced = -1;
+        for (int i = events.size(); --i >= 0;) {
+            if ((events.getReference(i).type == VoiceEvent::Type::pitchWheel) == wheel) {
+                replaced = i;
+                break;
+            }
+        }
+        if (replaced < 0) {
+            if (wheel) {
+                return;
+            }
+            // Nothing but wheel moves queued, a note event matters more than one of them
+            replaced = events.size() - 1;
+        }
+        events.remove(replaced);
+    }
+    events.add({ type, eventSample, value, velocity });
+}
+
+void SynthVoice::applyEvent(const VoiceEvent& event) {
+    switch (event.type) {
+    case VoiceEvent::Type::noteOn:
+        note = event.value;
+        updatePitch();
+        modMatrix.noteOn(event.velocity);
+        post.reset();
+        grains.reset();
+        adsr.noteOn();
+        released = false;
+        silentSamples = 0;
+
+        // The orbit is restarted from the modulated point when the segment starts
+        restartPending = true;
+        break;
+    case VoiceEvent::Type::noteOff:
+        adsr.noteOff();
+        modMatrix.noteOff();
+        released = true;
+        break;
+    case VoiceEvent::Type::stop:
+        adsr.reset();
+        modMatrix.noteOff();
+        released = true;
+        break;
+    case VoiceEvent::Type::pitchWheel:
+        pitchWheel = event.value;
+        updatePitch();
+        break;
+    }
+}
 
+void SynthVoice::updatePitch() {
+    // The root note plays the orbit at max_freq points per second
+    const double bend = (pitchWheel - 8192) / 8192.0 * pitch_bend_range;
+    const double ratio = std::pow(2.0, (note - root_note + bend) / 12.0);
+    orbit.setPitch(ratio);
+    grains.setPitch(ratio);
 }
 
 void SynthVoice::controllerMoved(int controllerNumber, int newControllerValue) {
+    if (controllerNumber == 1) {
+        modMatrix.setModWheel(newControllerValue / 127.0f);
+    }
+}
 
+void SynthVoice::aftertouchChanged(int newAftertouchValue) {
+    modMatrix.setAftertouch(newAftertouchValue / 127.0f);
+}
+
+void SynthVoice::channelPressureChanged(int newChannelPressureValue) {
+    modMatrix.setAftertouch(newChannelPressureValue / 127.0f);
 }
 
 void SynthVoice::prepareToPlay(double sampleRate, int samplesPerBlock, int outputChannels) {
     adsr.setSampleRate(sampleRate);
+    silenceHoldSamples = juce::roundToInt(silence_hold_seconds * sampleRate);
 
     juce::dsp::ProcessSpec spec;
     spec.maximumBlockSize = samplesPerBlock;
     spec.sampleRate = sampleRate;
     spec.numChannels = outputChannels;
 
-    osc1.prepareToPlay(spec);
-    osc2.prepareToPlay(spec);
+    orbit.prepareToPlay(sampleRate);
+    grains.prepareToPlay(sampleRate);
+    post.prepare(sampleRate, samplesPerBlock);
+    modMatrix.prepare(sampleRate, samplesPerBlock);
     gain.prepare(spec);
 
+    synthBuffer.setSize(2, samplesPerBlock);
+    events.ensureStorageAllocated(max_events);
+
     gain.setGainLinear(0.3f);
 
     isPrepared = true;
@@ -57,39 +140,195 @@ void SynthVoice::update(const float attack, const float decay, const float susta
     adsr.updateADSR(attack, decay, sustain, release);
 }
 
+void SynthVoice::updateModulation(const std::array<ModSlot, ModMatrixData::num_slots>& slots, float lfoRate1, float lfoRate2,
+                                  float attack, float decay, float sustain, float release) {
+    modMatrix.setSlots(slots);
+    modMatrix.setLfoRates(lfoRate1, lfoRate2);
+    modMatrix.setEnvelope(attack, decay, sustain, release);
+}
+
+void SynthVoice::setEngine(int engine) {
+    const bool nowGranular = (engine == engine_granular);
+    if (nowGranular != granular) {
+        granular = nowGranular;
+        grains.reset();
+        restartPending = true;
+    }
+}
+
+void SynthVoice::setPoint(float x, float y, float cx, float cy) {
+    point_x = x;
+    point_y = y;
+    point_cx = cx;
+    point_cy = cy;
+}
+
+void SynthVoice::applyPoint() {
+    // Start point modulation is only ever block-rate, audio-rate it would be a new point every sample
+    const auto* movingX = modMatrix.getMovingOffset(ModMatrixData::startX);
+    const auto* movingY = modMatrix.getMovingOffset(ModMatrixData::startY);
+    const float x = point_x + modMatrix.getOffset(ModMatrixData::startX) + (movingX != nullptr ? movingX[0] : 0.0f);
+    const float y = point_y + modMatrix.getOffset(ModMatrixData::startY) + (movingY != nullptr ? movingY[0] : 0.0f);
+    const float cx = point_cx + modMatrix.getOffset(ModMatrixData::cX);
+    const float cy = point_cy + modMatrix.getOffset(ModMatrixData::cY);
+
+    // A new note, a dragged point or block-rate c restarts the orbit. Modulation of
+    // the start alone nudges the running orbit instead, restarting it every block buzzes.
+    if (restartPending || point_x != dragged_x || point_y != dragged_y || cx != applied_cx || cy != applied_cy) {
+        dragged_x = point_x;
+        dragged_y = point_y;
+        applied_x = x;
+        applied_y = y;
+        applied_cx = cx;
+        applied_cy = cy;
+        restartPending = false;
+        orbit.setPoint(x, y, cx, cy);
+    }
+    else if (x != applied_x || y != applied_y) {
+        applied_x = x;
+        applied_y = y;
+        orbit.moveStart(x, y);
+    }
+    orbit.setMovingConstant(modMatrix.getMovingOffset(ModMatrixData::cX), modMatrix.getMovingOffset(ModMatrixData::cY));
+
+    // Without a Julia c every point is its own c, and so is every grain's start
+    grains.setConstant(cx, cy, point_cx == point_x && point_cy == point_y);
+}
+
+void SynthVoice::applyGainModulation(int numSamples) {
+    const float offset = 1.0f + modMatrix.getOffset(ModMatrixData::gain);
+    const float* moving = modMatrix.getMovingOffset(ModMatrixData::gain);
+
+    for (int channel = 0; channel < 2; ++channel) {
+        float* data = synthBuffer.getWritePointer(channel);
+        if (moving == nullptr) {
+            if (offset != 1.0f) {
+                juce::FloatVectorOperations::multiply(data, juce::jmax(0.0f, offset), numSamples);
+            }
+        }
+        else {
+            for (int i = 0; i < numSamples; ++i) {
+                data[i] *= juce::jmax(0.0f, offset + moving[i]);
+            }
+        }
+    }
+}
+
 void SynthVoice::renderNextBlock(juce::AudioBuffer< float >& outputBuffer, int startSample, int numSamples) {
     jassert(isPrepared);
 
-    if (!isVoiceActive()) {
+    // Events queued from now on belong to the next block, whether or not this one renders
+    eventSample = 0;
+
+    if (events.isEmpty() && !adsr.isActive()) {
+        if (isVoiceActive()) {
+            clearCurrentNote();
+        }
         return;
     }
 
-    leftSynthBuffer.setSize(outputBuffer.getNumChannels(), numSamples, false, false, false);
-    leftSynthBuffer.clear();
+    // Only note starts and stops split the block, pitch wheel moves are applied
+    // inside the segment by the orbit alone
+    int nextEvent = 0;
+    int pos = 0;
+    while (pos < numSamples) {
+        while (nextEvent < events.size() && events.getReference(nextEvent).sample <= pos) {
+            applyEvent(events.getReference(nextEvent++));
+        }
+
+        // Hosts may pass more than the prepared block size, which the mod matrix isn't sized for
+        int end = juce::jmin(numSamples, pos + modMatrix.getMaxBlockSize());
+        for (int i = nextEvent; i < events.size(); ++i) {
+            if (events.getReference(i).type != VoiceEvent::Type::pitchWheel) {
+                end = juce::jmin(end, events.getReference(i).sample);
+                break;
+            }
+        }
+
+        if (adsr.isActive()) {
+            renderSegment(outputBuffer, startSample, pos, end - pos, nextEvent);
+        }
+        pos = end;
+    }
+
+    // Events stamped past the end of a shorter block
+    while (nextEvent < events.size()) {
+        applyEvent(events.getReference(nextEvent++));
+    }
+    events.clearQuick();
 
-    juce::dsp::AudioBlock<float> leftAudioBlock { leftSynthBuffer };
+    if (isVoiceActive() && !adsr.isActive()) {
+        clearCurrentNote();
+    }
+}
 
-    osc1.getNextAudioBlock(leftAudioBlock);
-    gain.process(juce::dsp::ProcessContextReplacing<float>(leftAudioBlock));
+void SynthVoice::renderSegment(juce::AudioBuffer<float>& outputBuffer, int startSample, int segmentStart, int numSamples, int& nextEvent) {
+    synthBuffer.setSize(2, numSamples, false, false, true);
 
-    adsr.applyEnvelopeToBuffer(leftSynthBuffer, 0, leftSynthBuffer.getNumSamples());
+    modMatrix.process(numSamples);
+    orbit.setRecordOffset(startSample + segmentStart);
+    applyPoint();
 
-    outputBuffer.addFrom(0, startSample, leftSynthBuffer, 0, 0, numSamples);
+    // Pitch wheel moves inside the segment only retune the orbit
+    int from = 0;
+    while (nextEvent < events.size() && events.getReference(nextEvent).type == VoiceEvent::Type::pitchWheel) {
+        const int at = events.getReference(nextEvent).sample - segmentStart;
+        if (at >= numSamples) {
+            break;
+        }
+        renderOrbit(from, at);
+        applyEvent(events.getReference(nextEvent++));
+        from = at;
+    }
+    renderOrbit(from, numSamples);
 
-    rightSynthBuffer.setSize(outputBuffer.getNumChannels(), numSamples, false, false, false);
-    rightSynthBuffer.clear();
+    post.process(synthBuffer, numSamples);
+    applyGainModulation(numSamples);
 
-    juce::dsp::AudioBlock<float> rightAudioBlock{ rightSynthBuffer };
+    juce::dsp::AudioBlock<float> audioBlock { synthBuffer };
+    gain.process(juce::dsp::ProcessContextReplacing<float>(audioBlock));
 
-    osc2.getNextAudioBlock(rightAudioBlock);
-    gain.process(juce::dsp::ProcessContextReplacing<float>(rightAudioBlock));
+    adsr.applyEnvelopeToBuffer(synthBuffer, 0, synthBuffer.getNumSamples());
 
-    adsr.applyEnvelopeToBuffer(rightSynthBuffer, 0, rightSynthBuffer.getNumSamples());
-    
-    outputBuffer.addFrom(1, startSample, rightSynthBuffer, 1, 0, numSamples);
+    for (int channel = 0; channel < outputBuffer.getNumChannels(); ++channel) {
+        outputBuffer.addFrom(channel, startSample + segmentStart, synthBuffer, juce::jmin(channel, 1), 0, numSamples);
+    }
 
-    if (!adsr.isActive()) {
-        clearCurrentNote();
+    detectSilence(numSamples);
+}
+
+void SynthVoice::detectSilence(int numSamples) {
+    // Only released notes, a held note can come back from silence when the point moves
+    if (!released) {
+        return;
+    }
+
+    const float level = juce::jmax(synthBuffer.getMagnitude(0, 0, numSamples), synthBuffer.getMagnitude(1, 0, numSamples));
+    if (level >= silence_threshold) {
+        silentSamples = 0;
+        return;
+    }
+
+    // The rest of the release is inaudible, end it so the voice is freed with this block
+    silentSamples += numSamples;
+    if (silentSamples >= silenceHoldSamples) {
+        adsr.reset();
     }
 }
 
+void SynthVoice::renderOrbit(int from, int to) {
+    if (to <= from) {
+        return;
+    }
+    if (from > 0) {
+        // Audio-rate c has to line up with the part of the segment being rendered
+        const float* movingCx = modMatrix.getMovingOffset(ModMatrixData::cX);
+        const float* movingCy = modMatrix.getMovingOffset(ModMatrixData::cY);
+        orbit.setMovingConstant(movingCx != nullptr ? movingCx + from : nullptr, movingCy != nullptr ? movingCy + from : nullptr);
+    }
+    if (granular) {
+        grains.getNextAudioBlock(synthBuffer, from, to - from);
+        return;
+    }
+    orbit.getNextAudioBlock(synthBuffer, from, to - from);
+}
@@ -13,7 +13,10 @@
 #include <JuceHeader.h>
 #include "SynthSound.h"
 #include "Data/ADSRData.h"
-#include "Data/OscData.h"
+#include "Data/OrbitData.h"
+#include "Data/GrainEngine.h"
+#include "Data/PostChainData.h"
+#include "Data/ModMatrixData.h"
 
 class SynthVoice : public juce::SynthesiserVoice {
 public:
@@ -22,19 +25,74 @@ public:
     void stopNote(float velocity, bool allowTailOff) override;
     void pitchWheelMoved(int newPitchWheelValue) override;
     void controllerMoved(int controllerNumber, int newControllerValue) override;
+    void aftertouchChanged(int newAftertouchValue) override;
+    void channelPressureChanged(int newChannelPressureValue) override;
     void prepareToPlay(double sampleRate, int samplesPerBlock, int outputChannels);
     void renderNextBlock(juce::AudioBuffer< float >& outputBuffer, int startSample, int numSamples) override;
 
     void update(const float attack, const float decay, const float sustain, const float release);
-    OscData& getOscillator1() { return osc1; }
-    OscData& getOscillator2() { return osc2; }
+    void updateModulation(const std::array<ModSlot, ModMatrixData::num_slots>& slots, float lfoRate1, float lfoRate2,
+                          float attack, float decay, float sustain, float release);
+    void setPoint(float x, float y, float cx, float cy);
+    OrbitData& getOrbit() { return orbit; }
+    GrainEngine& getGrains() { return grains; }
+    // Which of the two plays: engine_orbit or engine_granular
+    void setEngine(int engine);
+
+    // Sample position, within the next block, of the MIDI events dispatched from now on.
+    void setEventSample(int sample) { eventSample = sample; }
+
+    enum Engine { engine_orbit, engine_granular };
+
+    static const int root_note = 60;
+    static constexpr double pitch_bend_range = 2.0; // Semitones
+    static const int max_events = 256;
+
+    // A released voice is freed once its output has stayed below the threshold this long
+    static constexpr float silence_threshold = 1e-4f; // -80 dBFS
+    static constexpr double silence_hold_seconds = 0.02;
 private:
+    // Note and pitch events are queued and applied at their sample in renderNextBlock
+    struct VoiceEvent {
+        enum class Type { noteOn, noteOff, stop, pitchWheel };
+        Type type;
+        int sample;
+        int value;          // Note number, or pitch wheel position
+        float velocity;
+    };
+
+    void queueEvent(VoiceEvent::Type type, int value, float velocity);
+    void applyEvent(const VoiceEvent& event);
+    void renderSegment(juce::AudioBuffer<float>& outputBuffer, int startSample, int segmentStart, int numSamples, int& nextEvent);
+    void renderOrbit(int from, int to);
+    void detectSilence(int numSamples);
+    void updatePitch();
+    void applyPoint();
+    void applyGainModulation(int numSamples);
+
     ADSRData adsr;
-    juce::AudioBuffer<float> leftSynthBuffer;
-    juce::AudioBuffer<float> rightSynthBuffer;
+    juce::AudioBuffer<float> synthBuffer;
+
+    OrbitData orbit;
+    GrainEngine grains;
+    bool granular = false;
+    PostChainData post;
+    ModMatrixData modMatrix;
+    float point_x = 0.0f, point_y = 0.0f;
+    float point_cx = 0.0f, point_cy = 0.0f;
+    // The point as last dragged, and as last applied with modulation
+    float dragged_x = 0.0f, dragged_y = 0.0f;
+    float applied_x = 0.0f, applied_y = 0.0f;
+    float applied_cx = 0.0f, applied_cy = 0.0f;
+    bool restartPending = false;
+    bool released = false;
+    int silentSamples = 0;
+    int silenceHoldSamples = 960;
+    int note = root_note;
+    int pitchWheel = 8192;
 
-    OscData osc1;
-    OscData osc2;
+    juce::Array<VoiceEvent> events;
+    int eventSample = 0;
     juce::dsp::Gain<float> gain;
     bool isPrepared{ false };
 };
@@ -0,0 +1,63 @@
+/*
+  ==============================================================================
+
+    FormulaComponent.cpp
+    Created: 23 Oct 2026 2:41:18pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "FormulaComponent.h"
+
+//==============================================================================
+FormulaComponent::FormulaComponent(PhractalAudioProcessor& pap)
+    : audioProcessor(pap)
+{
+    formulaEditor.setText(audioProcessor.getFormula()->getSource(), false);
+    formulaEditor.setFont(juce::Font(juce::Font::getDefaultMonospacedFontName(), 14.0f, juce::Font::plain));
+    formulaEditor.setTextToShowWhenEmpty(PhractalAudioProcessor::default_formula, juce::Colours::grey);
+    formulaEditor.onReturnKey = [this] { compile(); };
+    addAndMakeVisible(formulaEditor);
+
+    status.setFont(juce::Font(12.0f));
+    addAndMakeVisible(status);
+
+    showCompiled();
+}
+
+FormulaComponent::~FormulaComponent()
+{
+}
+
+void FormulaComponent::compile()
+{
+    juce::String error;
+    if (audioProcessor.setFormula(formulaEditor.getText(), error)) {
+        showCompiled();
+    }
+    else {
+        status.setText(error, juce::dontSendNotification);
+        status.setColour(juce::Label::textColourId, juce::Colours::orangered);
+    }
+}
+
+void FormulaComponent::showCompiled()
+{
+    const int size = audioProcessor.getFormula()->getNumInstructions();
+    status.setText("Custom: " + juce::String(size) + " instructions", juce::dontSendNotification);
+    status.setColour(juce::Label::textColourId, juce::Colours::grey);
+}
+
+void FormulaComponent::paint (juce::Graphics& g)
+{
+    g.fillAll(juce::Colours::black);
+}
+
+void FormulaComponent::resized()
+{
+    auto bounds = getLocalBounds().reduced(5);
+    formulaEditor.setBounds(bounds.removeFromTop(24));
+    status.setBounds(bounds);
+}
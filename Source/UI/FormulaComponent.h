@@ -0,0 +1,40 @@
+/*
+  ==============================================================================
+
+    FormulaComponent.h
+    Created: 23 Oct 2026 2:41:18pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../PluginProcessor.h"
+
+//==============================================================================
+/*
+    Text entry for the map of the "Custom" wave type. Return compiles it, and
+    a formula that doesn't compile leaves the previous one playing.
+*/
+class FormulaComponent  : public juce::Component
+{
+public:
+    FormulaComponent(PhractalAudioProcessor& pap);
+    ~FormulaComponent() override;
+
+    void paint (juce::Graphics&) override;
+    void resized() override;
+
+private:
+    void compile();
+    void showCompiled();
+
+    PhractalAudioProcessor& audioProcessor;
+
+    juce::TextEditor formulaEditor;
+    juce::Label status;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FormulaComponent)
+};
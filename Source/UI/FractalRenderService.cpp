@@ -0,0 +1,104 @@
+/*
+  ==============================================================================
+
+    FractalRenderService.cpp
+    Created: 22 Oct 2026 2:41:17pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#include "FractalRenderService.h"
+
+static const int tick_hz = 60;
+
+FractalRenderService::FractalRenderService()
+{
+    startTimerHz(tick_hz);
+}
+
+FractalRenderService::~FractalRenderService()
+{
+    stopTimer();
+    jassert(views.empty() && members.isEmpty());
+}
+
+void FractalRenderService::addView(View* view)
+{
+    views.push_back({ view });
+    due.reserve(views.size());
+}
+
+void FractalRenderService::removeView(View* view)
+{
+    views.erase(std::remove_if(views.begin(), views.end(), [view](const Entry& entry) {
+        return entry.view == view;
+    }), views.end());
+}
+
+void FractalRenderService::timerCallback()
+{
+    PHRACTAL_TRACE_SCOPE("FractalRenderService::timerCallback");
+    due.clear();
+    for (auto& entry : views) {
+        entry.priority = entry.view->getRenderPriority();
+        if (entry.priority == View::hidden) {
+            entry.ticksWaiting = 0;
+            continue;
+        }
+        ++entry.ticksWaiting;
+        if (entry.priority == View::animating || entry.ticksWaiting >= tick_hz / idle_fps) {
+            due.push_back(&entry);
+        }
+    }
+
+    // Animating views first, then whoever has waited longest, so a busy session
+    // drops frames evenly instead of starving the same view
+    std::sort(due.begin(), due.end(), [](const Entry* a, const Entry* b) {
+        const int rankA = a->ticksWaiting + (a->priority == View::animating ? tick_hz : 0);
+        const int rankB = b->ticksWaiting + (b->priority == View::animating ? tick_hz : 0);
+        return rankA > rankB;
+    });
+
+    float spent = 0.0f;
+    for (auto* entry : due) {
+        const float cost = entry->view->lastFrameMs.load();
+        if (spent > 0.0f && spent + cost > frame_budget_ms) {
+            break;
+        }
+        entry->view->renderFrame();
+        entry->ticksWaiting = 0;
+        spent += cost;
+    }
+}
+
+void* FractalRenderService::getShareContext() const
+{
+    const juce::ScopedLock sl(groupLock);
+    return members.isEmpty() ? nullptr : members.getFirst();
+}
+
+ShaderProgramCache* FractalRenderService::joinShareGroup(void* context, void* sharedWith)
+{
+    const juce::ScopedLock sl(groupLock);
+    if (members.isEmpty()) {
+        // First context of a new group; anything it was created to share with has closed since
+        const juce::ScopedLock pl(programLock);
+        sharedPrograms.contextCreated();
+    }
+    else if (sharedWith == nullptr || !members.contains(sharedWith)) {
+        return nullptr;
+    }
+    members.add(context);
+    return &sharedPrograms;
+}
+
+void FractalRenderService::leaveShareGroup(void* context)
+{
+    const juce::ScopedLock sl(groupLock);
+    members.removeFirstMatchingValue(context);
+    if (members.isEmpty()) {
+        const juce::ScopedLock pl(programLock);
+        sharedPrograms.release();
+    }
+}
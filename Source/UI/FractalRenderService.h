@@ -0,0 +1,79 @@
+/*
+  ==============================================================================
+
+    FractalRenderService.h
+    Created: 22 Oct 2026 2:41:17pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ShaderProgramCache.h"
+#include "../Data/PerfTrace.h"
+
+// Process-wide frame scheduler and GL share group for every open fractal view,
+// held through a juce::SharedResourcePointer so all plugin instances in the host
+// get the same one. Instead of each context repainting continuously, one timer
+// hands out frames: views that are animating go first, still views are refreshed
+// at idle_fps, hidden views get nothing, and a tick stops handing out frames once
+// the views' last measured frame times add up to frame_budget_ms.
+// Contexts created while another view's context is alive share its GL objects,
+// so the compiled programs are built once and owned by the group.
+class FractalRenderService : private juce::Timer {
+public:
+    class View {
+    public:
+        virtual ~View() = default;
+
+        enum Priority { hidden, still, animating };
+
+        // Message thread.
+        virtual Priority getRenderPriority() = 0;
+        virtual void renderFrame() = 0;
+
+        // Written by the view's render thread after every frame
+        std::atomic<float> lastFrameMs { 1.0f };
+    };
+
+    FractalRenderService();
+    ~FractalRenderService() override;
+
+    // Message thread.
+    void addView(View* view);
+    void removeView(View* view);
+
+    // Message thread, right before attaching a new context: a live context to share with, or null.
+    void* getShareContext() const;
+
+    // Render thread of the context, from newOpenGLContextCreated. Returns the group's
+    // program cache, or null if the context couldn't share and has to use its own.
+    ShaderProgramCache* joinShareGroup(void* context, void* sharedWith);
+    // From openGLContextClosing. The last context to leave releases the shared programs.
+    void leaveShareGroup(void* context);
+
+    // Held around every use of the shared cache, the contexts may render on different threads
+    juce::CriticalSection& getProgramLock() { return programLock; }
+
+    static const int idle_fps = 10;
+    static constexpr float frame_budget_ms = 12.0f;
+private:
+    void timerCallback() override;
+
+    struct Entry {
+        View* view;
+        View::Priority priority = View::hidden;
+        int ticksWaiting = 0;
+    };
+    std::vector<Entry> views;
+    std::vector<Entry*> due;
+
+    mutable juce::CriticalSection groupLock;
+    juce::Array<void*> members;
+    juce::CriticalSection programLock;
+    ShaderProgramCache sharedPrograms;
+
+    JUCE_DECLARE_NON_COPYABLE (FractalRenderService)
+};
@@ -10,170 +10,11 @@
 
 #include <JuceHeader.h>
 #include "FractalRendererComponent.h"
+#include "../Render/PosterExporter.h"
+#include "../Render/ZoomPathRenderer.h"
 
-void mandelbrot(float& x, float& y, float cx, float cy) {
-    float nx = x * x - y * y + cx;
-    float ny = 2.0 * x * y + cy;
-    x = nx;
-    y = ny;
-}
-void burning_ship(float& x, float& y, float cx, float cy) {
-    float nx = x * x - y * y + cx;
-    float ny = 2.0 * std::abs(x * y) + cy;
-    x = nx;
-    y = ny;
-}
-void feather(float& x, float& y, float cx, float cy) {
-    std::complex<float> z(x, y);
-    std::complex<float> z2(x * x, y * y);
-    std::complex<float> c(cx, cy);
-    std::complex<float> one(1.0, 0.0);
-    z = z * z * z / (one + z2) + c;
-    x = z.real();
-    y = z.imag();
-}
-void sfx(float& x, float& y, float cx, float cy) {
-    std::complex<float> z(x, y);
-    std::complex<float> c2(cx * cx, cy * cy);
-    z = z * (x * x + y * y) - (z * c2);
-    x = z.real();
-    y = z.imag();
-}
-void henon(float& x, float& y, float cx, float cy) {
-    float nx = 1.0 - cx * x * x + y;
-    float ny = cy * x;
-    x = nx;
-    y = ny;
-}
-void duffing(float& x, float& y, float cx, float cy) {
-    float nx = y;
-    float ny = -cy * x + cx * y - y * y * y;
-    x = nx;
-    y = ny;
-}
-void ikeda(float& x, float& y, float cx, float cy) {
-    float t = 0.4 - 6.0 / (1.0 + x * x + y * y);
-    float st = std::sin(t);
-    float ct = std::cos(t);
-    float nx = 1.0 + cx * (x * ct - y * st);
-    float ny = cy * (x * st + y * ct);
-    x = nx;
-    y = ny;
-}
-void chirikov(float& x, float& y, float cx, float cy) {
-    y += cy * std::sin(x);
-    x += cx * y;
-}
-
-//==============================================================================
-FractalRendererComponent::FractalRendererComponent(const PhractalAudioProcessor& pap)
-    : audioProcessor(pap)
-{
-    // Indicates that no part of this Component is transparent.
-    setOpaque(true);
-
-    // Set this instance as the renderer for the context.
-    openGLContext.setRenderer(this);
-
-    // Tell the context to repaint on a loop.
-    openGLContext.setContinuousRepainting(true);
-
-    // Finally - we attach the context to this Component.
-    openGLContext.attachTo(*this);
-
-    setWantsKeyboardFocus(true);
-}
-
-FractalRendererComponent::~FractalRendererComponent()
-{
-    // Tell the context to stop using this Component.
-    openGLContext.detach();
-}
-
-void FractalRendererComponent::paint (juce::Graphics& g)
-{
-}
-
-void FractalRendererComponent::resized()
-{
-    // This method is where you should set the bounds of any child
-    // components that your component contains..
-
-}
-
-void FractalRendererComponent::newOpenGLContextCreated()
-{
-    // Generate 1 buffer, using our vbo variable to store its ID.
-    openGLContext.extensions.glGenBuffers(1, &vbo);
-
-    // Generate 1 more buffer, this time using our IBO variable.
-    openGLContext.extensions.glGenBuffers(1, &ibo);
-
-    // Create 4 vertices each with a different colour.
-    vertexBuffer = {
-        // Vertex 0
-        {
-            { -1.f, 1.f },        // (-1, 1)
-            { 1.f, 0.f, 0.f, 1.f }  // Red
-        },
-        // Vertex 1
-        {
-            { 1.f, 1.f },         // (1, 1)
-            { 1.f, 0.5f, 0.f, 1.f } // Orange
-        },
-        // Vertex 2
-        {
-            { 1.f, -1.f },        // (1, -1)
-            { 1.f, 1.f, 0.f, 1.f }  // Yellow
-        },
-        // Vertex 3
-        {
-            { -1.f, -1.f },       // (-1, -1)
-            { 1.f, 0.f, 1.f, 1.f }  // Purple
-        }
-    };
-
-    // We need 6 indices, 1 for each corner of the two triangles.
-    indexBuffer = {
-        0, 1, 2,
-        0, 2, 3
-    };
-
-    // Bind the VBO.
-    openGLContext.extensions.glBindBuffer(juce::gl::GL_ARRAY_BUFFER, vbo);
-
-    // Send the vertices data.
-    openGLContext.extensions.glBufferData(
-        juce::gl::GL_ARRAY_BUFFER,                        // The type of data we're sending.           
-        sizeof(Vertex) * vertexBuffer.size(),   // The size (in bytes) of the data.
-        vertexBuffer.data(),                    // A pointer to the actual data.
-        juce::gl::GL_STATIC_DRAW                          // How we want the buffer to be drawn.
-    );
-
-    // Bind the IBO.
-    openGLContext.extensions.glBindBuffer(juce::gl::GL_ELEMENT_ARRAY_BUFFER, ibo);
-
-    // Send the indices data.
-    openGLContext.extensions.glBufferData(
-        juce::gl::GL_ELEMENT_ARRAY_BUFFER,
-        sizeof(unsigned int) * indexBuffer.size(),
-        indexBuffer.data(),
-        juce::gl::GL_STATIC_DRAW
-    );
-
-    vertexShader =
+static const char fragment_shader_prelude[] =
         R"(
-            #version 400 compatibility
-            uniform vec2 iResolution;
-
-            void main() {
-                gl_Position = vec4(gl_Vertex.xy, 0.0, 1.0);
-            }
-        )";
-
-    fragmentShader =
-        R"(
-            #version 400 compatibility
             //#extension GL_ARB_gpu_shader_fp64 : enable
             #pragma optionNV(fastmath off)
             #pragma optionNV(fastprecision off)
@@ -181,19 +22,19 @@ void FractalRendererComponent::newOpenGLContextCreated()
             #define FLOAT float
             #define VEC2 vec2
             #define VEC3 vec3
-            #define AA_LEVEL 1
             #define ESCAPE 1000.0
             #define PI 3.141592653
+            #define CYCLE_EPS 1e-12
+            #define DE_AA_RADIUS 2.0
+            #define DE_INTERIOR 1e20
 
             #define FLAG_DRAW_MSET ((iFlags & 0x01) == 0x01)
             #define FLAG_DRAW_JSET ((iFlags & 0x02) == 0x02)
-            #define FLAG_USE_COLOR ((iFlags & 0x04) == 0x04)
 
             uniform vec2 iResolution;
             uniform vec2 iCam;
             uniform vec2 iJulia;
             uniform float iZoom;
-            uniform int iType;
             uniform int iIters;
             uniform int iFlags;
             uniform int iTime;
@@ -218,176 +59,446 @@ void FractalRendererComponent::newOpenGLContextCreated()
                 FLOAT denom = 1.0 / (b.x*b.x + b.y*b.y);
                 return VEC2(a.x*b.x + a.y*b.y, a.y*b.x - a.x*b.y) * denom;
             }
+            // Same trig as the formula's CPU side, ph_sin and ph_cos come from fractal_glsl_trig
             VEC2 cx_sin(VEC2 a) {
-                return VEC2(sin(a.x) * cosh(a.y), cos(a.x) * sinh(a.y));
+                return VEC2(ph_sin(a.x) * cosh(a.y), ph_cos(a.x) * sinh(a.y));
             }
             VEC2 cx_cos(VEC2 a) {
-                return VEC2(cos(a.x) * cosh(a.y), -sin(a.x) * sinh(a.y));
+                return VEC2(ph_cos(a.x) * cosh(a.y), -ph_sin(a.x) * sinh(a.y));
             }
             VEC2 cx_exp(VEC2 a) {
-                return exp(a.x) * VEC2(cos(a.y), sin(a.y));
+                return exp(a.x) * VEC2(ph_cos(a.y), ph_sin(a.y));
             }
 
-            //Fractal equations
-            VEC2 mandelbrot(VEC2 z, VEC2 c) {
-                return cx_sqr(z) + c;
-            }
-            VEC2 burning_ship(VEC2 z, VEC2 c) {
-                return VEC2(z.x*z.x - z.y*z.y, 2.0*abs(z.x * z.y)) + c;
-            }
-            VEC2 feather(VEC2 z, VEC2 c) {
-                return cx_div(cx_cube(z), cx_one + z*z) + c;
-            }
-            VEC2 sfx(VEC2 z, VEC2 c) {
-                return z * dot(z,z) - cx_mul(z, c*c);
-            }
-            VEC2 henon(VEC2 z, VEC2 c) {
-                return VEC2(1.0 - c.x*z.x*z.x + z.y, c.y * z.x);
-            }
-            VEC2 duffing(VEC2 z, VEC2 c) {
-                return VEC2(z.y, -c.y*z.x + c.x*z.y - z.y*z.y*z.y);
+        )";
+
+// Everything after the maps, which fractal_glsl_maps (FractalMaps.h) provides in between
+static const char fragment_shader_body[] =
+        R"(
+            //Derivatives of the maps along dz (Jacobian times dz), for the distance estimate
+            VEC2 d_mandelbrot(VEC2 z, VEC2 dz) {
+                return 2.0 * cx_mul(z, dz);
             }
-            VEC2 ikeda(VEC2 z, VEC2 c) {
-                FLOAT t = 0.4 - 6.0/(1.0 + dot(z,z));
-                FLOAT st = sin(t);
-                FLOAT ct = cos(t);
-                return VEC2(1.0 + c.x*(z.x*ct - z.y*st), c.y*(z.x*st + z.y*ct));
+            VEC2 d_burning_ship(VEC2 z, VEC2 dz) {
+                FLOAT s = sign(z.x * z.y);
+                return 2.0 * VEC2(z.x*dz.x - z.y*dz.y, s*(z.y*dz.x + z.x*dz.y));
             }
-            VEC2 chirikov(VEC2 z, VEC2 c) {
-                z.y += c.y*sin(z.x);
-                z.x += c.x*z.y;
-                return z;
+            VEC2 d_feather(VEC2 z, VEC2 dz) {
+                VEC2 w = cx_one + z*z;
+                VEC2 dw = 2.0 * z * dz;
+                VEC2 du = 3.0 * cx_mul(cx_sqr(z), dz);
+                return cx_div(cx_mul(du, w) - cx_mul(cx_cube(z), dw), cx_sqr(w));
             }
 
-            #if 1
+            // With USE_DE the derivative of the orbit with respect to the pixel is carried
+            // along for the exterior distance estimate. dz starts at 1 for both sets, and
+            // dc is 1 for the Mandelbrot set (c moves with the pixel) and 0 for Julia sets.
+            #if USE_DE
+            #define DE_STEP dz = FRACTAL_DERIV(z, dz) + dc;
+            #else
+            #define DE_STEP
+            #endif
+            FLOAT g_de;
+
+            // Brent cycle detection: zc is moved forward at every power of two, and
+            // the loop exits once the orbit has returned to it twice, one period
+            // apart (see CycleDetector.h).
+            #if USE_COLOR
+            #define CYCLE_FOUND n = i + 1;
+            #else
+            #define CYCLE_FOUND
+            #endif
+            #define CYCLE_CHECK \
+                zscale = max(zscale, dot(z, z)); \
+                if (dot(z - zc, z - zc) <= CYCLE_EPS * zscale) { \
+                    if (plen + 1 == pcand) { CYCLE_FOUND i = iIters; break; } \
+                    pcand = plen + 1; plen = 0; pmax = pcand; zc = z; continue; \
+                } \
+                if (++plen == pmax) { plen = 0; pmax += pmax; zc = z; }
+            #if USE_COLOR
             #define DO_LOOP(name) \
                 for (i = 0; i < iIters; ++i) { \
                     VEC2 ppz = pz; \
                     pz = z; \
+                    DE_STEP \
                     z = name(z, c); \
                     if (dot(z, z) > ESCAPE) { break; } \
                     sumz.x += dot(z - pz, pz - ppz); \
                     sumz.y += dot(z - pz, z - pz); \
                     sumz.z += dot(z - ppz, z - ppz); \
+                    CYCLE_CHECK \
                 }
             #else
             #define DO_LOOP(name) \
                 for (i = 0; i < iIters; ++i) { \
+                    DE_STEP \
                     z = name(z, c); \
                     if (dot(z, z) > ESCAPE) { break; } \
+                    CYCLE_CHECK \
                 }
             #endif
 
-            vec3 fractal(VEC2 z, VEC2 c) {
+            // Main cardioid and period-2 bulb of the Mandelbrot set (see mandelbrot_interior).
+            bool in_cardioid_or_bulb(VEC2 c) {
+                FLOAT qx = c.x - 0.25;
+                FLOAT q = qx*qx + c.y*c.y;
+                if (q*(q + qx) <= 0.25*c.y*c.y) { return true; }
+                FLOAT bx = c.x + 1.0;
+                return bx*bx + c.y*c.y <= 0.0625;
+            }
+
+            vec3 fractal(VEC2 z, VEC2 c, VEC2 dc) {
+                VEC2 zc = z;
+                VEC2 dz = VEC2(1.0, 0.0);
+                int i;
+                FLOAT zscale = dot(z, z);
+                int plen = 0;
+                int pmax = 1;
+                int pcand = 0;
+            #if USE_COLOR
                 VEC2 pz = z;
                 VEC3 sumz = VEC3(0.0, 0.0, 0.0);
-                int i;
-                switch (iType) {
-                case 0: DO_LOOP(mandelbrot); break;
-                case 1: DO_LOOP(burning_ship); break;
-                case 2: DO_LOOP(feather); break;
-                case 3: DO_LOOP(sfx); break;
-                case 4: DO_LOOP(henon); break;
-                case 5: DO_LOOP(duffing); break;
-                case 6: DO_LOOP(ikeda); break;
-                case 7: DO_LOOP(chirikov); break;
-                }
+                int n = iIters;
+            #endif
+                DO_LOOP(FRACTAL);
 
                 if (i != iIters) {
+                #if USE_DE
+                    FLOAT r = length(z);
+                    g_de = min(g_de, 0.5 * r * log(r) / max(length(dz), 1e-20));
+                #endif
                     float n1 = sin(float(i) * 0.1) * 0.5 + 0.5;
                     float n2 = cos(float(i) * 0.1) * 0.5 + 0.5;
-                    return vec3(n1, n2, 1.0) * (1.0 - float(FLAG_USE_COLOR)*0.85);
-                } else if (FLAG_USE_COLOR) {
-                    sumz = abs(sumz) / iIters;
-                    vec3 n1 = sin(abs(sumz * 5.0)) * 0.45 + 0.5;
-                    return n1;
-                } else {
-                    return vec3(0.0, 0.0, 0.0);
+                    return vec3(n1, n2, 1.0) * (1.0 - float(USE_COLOR)*0.85);
                 }
+            #if USE_COLOR
+                sumz = abs(sumz) / float(n);
+                vec3 n1 = sin(abs(sumz * 5.0)) * 0.45 + 0.5;
+                return n1;
+            #else
+                return vec3(0.0, 0.0, 0.0);
+            #endif
             }
 
             float rand(float s) {
                 return fract(sin(s*12.9898) * 43758.5453);
             }
 
+            // Colour of one sample, and g_de set to its distance to the set in pixels,
+            // or left at DE_INTERIOR if no orbit escaped
+            vec3 sample_point(vec2 screen_pos) {
+                VEC2 c = VEC2(screen_pos * vec2(1.0, -1.0) / iZoom - iCam);
+                vec3 col = vec3(0.0, 0.0, 0.0);
+                g_de = DE_INTERIOR;
+
+                if (FLAG_DRAW_MSET) {
+                #if FRACTAL_TYPE == 0 && !USE_COLOR
+                    // Interior points are black unless the colour statistics are needed
+                    if (!in_cardioid_or_bulb(c)) {
+                        col += fractal(c, c, VEC2(1.0, 0.0));
+                    }
+                #else
+                    col += fractal(c, c, VEC2(1.0, 0.0));
+                #endif
+                }
+                if (FLAG_DRAW_JSET) {
+                    col += fractal(c, iJulia, VEC2(0.0, 0.0));
+                }
+                if (FLAG_DRAW_MSET && FLAG_DRAW_JSET) {
+                    col *= 0.5;
+                }
+
+                if (g_de < DE_INTERIOR) {
+                    g_de *= iZoom;
+                }
+            #if USE_DE
+                // Exterior samples fade out as they approach the boundary
+                col *= clamp(g_de, 0.0, 1.0);
+            #endif
+                return col;
+            }
+
             void main() {
 	            //Get normalized screen coordinate
 	            vec2 screen_pos = gl_FragCoord.xy - (iResolution.xy * 0.5);
 
+            #if USE_DE
+                // One sample at the pixel centre; extra samples only near the boundary.
+                // Interior samples have no distance to go by, so an interior centre
+                // is always supersampled, which covers the inner side of the boundary.
+                // That costs no more than without DE, and exterior pixels away from
+                // the boundary still take one sample.
+                vec3 col = sample_point(screen_pos + 0.5);
+                if (AA_LEVEL > 1 && (g_de < DE_AA_RADIUS || g_de >= DE_INTERIOR)) {
+                    for (int i = 1; i < AA_LEVEL; ++i) {
+                        vec2 dxy = vec2(rand(i*0.54321 + iTime), rand(i*0.12345 + iTime));
+                        col += sample_point(screen_pos + dxy);
+                    }
+                    col /= AA_LEVEL;
+                }
+            #else
                 vec3 col = vec3(0.0, 0.0, 0.0);
                 for (int i = 0; i < AA_LEVEL; ++i) {
                     vec2 dxy = vec2(rand(i*0.54321 + iTime), rand(i*0.12345 + iTime));
-                    VEC2 c = VEC2((screen_pos + dxy) * vec2(1.0, -1.0) / iZoom - iCam);
-
-                    if (FLAG_DRAW_MSET) {
-                        col += fractal(c, c);
-                    }
-                    if (FLAG_DRAW_JSET) {
-                        col += fractal(c, iJulia);
-                    }
+                    col += sample_point(screen_pos + dxy);
                 }
-
                 col /= AA_LEVEL;
-                if (FLAG_DRAW_MSET && FLAG_DRAW_JSET) {
-                    col *= 0.5;
-                }
+            #endif
+
                 gl_FragColor = vec4(clamp(col, 0.0, 1.0), 1.0 / (iTime + 1.0));
             }
         )";
 
-    // Create an instance of OpenGLShaderProgram
-    shaderProgram.reset(new juce::OpenGLShaderProgram(openGLContext));
+static const int trail_program_key = 0x10000;
+static const int density_program_key = 0x10001;
+static const int julia_tile_program_key = 0x10002;
+static const float trail_fade_seconds = 0.5f;
+
+static const char density_vertex_shader[] =
+        R"(
+            #version 400 compatibility
+            out vec2 vUv;
+
+            void main() {
+                gl_Position = vec4(gl_Vertex.xy, 0.0, 1.0);
+                vUv = gl_Vertex.xy * 0.5 + 0.5;
+            }
+        )";
+
+// Row 0 of the density image is the top of the view
+static const char density_fragment_shader[] =
+        R"(
+            #version 400 compatibility
+            uniform sampler2D iDensity;
+            in vec2 vUv;
+
+            void main() {
+                gl_FragColor = vec4(texture(iDensity, vec2(vUv.x, 1.0 - vUv.y)).rgb, 1.0);
+            }
+        )";
+
+// One tile of the Julia atlas, iTile is its area in texture coordinates with row 0 at the top
+static const char julia_tile_fragment_shader[] =
+        R"(
+            #version 400 compatibility
+            uniform sampler2D iAtlas;
+            uniform vec4 iTile;
+            in vec2 vUv;
 
-    // Compile and link the shader.
-    // Each of these methods will return false if something goes wrong so we'll
-    // wrap them in an if statement
-    if (shaderProgram->addVertexShader(vertexShader)
-        && shaderProgram->addFragmentShader(fragmentShader)
-        && shaderProgram->link())
+            void main() {
+                gl_FragColor = vec4(texture(iAtlas, iTile.xy + vec2(vUv.x, 1.0 - vUv.y) * iTile.zw).rgb, 1.0);
+            }
+        )";
+
+// Formulas have no derivative to carry along
+static bool hasDistanceEstimate(int type) {
+    return type < num_fractals && fractal_has_distance_estimate[type];
+}
+
+// Bits of a program key above this hold the formula id, zero for the built-in maps
+static const int formula_key_shift = 12;
+
+static int programKey(int type, bool useColor, int aaLevel, bool useDe, const FormulaMap* formula = nullptr) {
+    const int key = type | (useColor ? 0x10 : 0) | (useDe && hasDistanceEstimate(type) ? 0x20 : 0) | (aaLevel << 8);
+    return (type == FormulaMap::custom_fractal && formula != nullptr) ? key | (formula->getId() << formula_key_shift) : key;
+}
+
+// Each (fractal type, colour mode, AA level) gets its own program, so the inner
+// loop has no map switch and skips the colour statistics when they aren't shown.
+// The custom type gets one per formula, with the formula's GLSL after the maps.
+static juce::String buildFragmentShader(int type, bool useColor, int aaLevel, bool useDe, const FormulaMap* formula = nullptr) {
+    const bool custom = (type == FormulaMap::custom_fractal);
+    const juce::String name = custom ? juce::String("custom") : juce::String(fractal_names[type]);
+    useDe = useDe && hasDistanceEstimate(type);
+    return juce::String("#version 400 compatibility\n")
+        + "#define FRACTAL " + name + "\n"
+        + "#define FRACTAL_DERIV d_" + name + "\n"
+        + "#define USE_DE " + juce::String(useDe ? 1 : 0) + "\n"
+        + "#define FRACTAL_TYPE " + juce::String(type) + "\n"
+        + "#define USE_COLOR " + juce::String(useColor ? 1 : 0) + "\n"
+        + "#define AA_LEVEL " + juce::String(aaLevel) + "\n"
+        + fractal_glsl_trig
+        + fragment_shader_prelude
+        + fractal_glsl_maps
+        + (custom && formula != nullptr ? formula->getGlsl() : juce::String())
+        + fragment_shader_body;
+}
+
+//==============================================================================
+FractalRendererComponent::FractalRendererComponent(PhractalAudioProcessor& pap)
+    : audioProcessor(pap)
+{
+    // Indicates that no part of this Component is transparent.
+    setOpaque(true);
+
+    // Set this instance as the renderer for the context.
+    openGLContext.setRenderer(this);
+
+    // Frames are handed out by the render service instead of repainting on a loop.
+    openGLContext.setContinuousRepainting(false);
+
+    // The context is attached once the component is showing, see updateAttachment
+    attacher = std::make_unique<ContextAttacher>(*this);
+    renderService->addView(this);
+
+    setWantsKeyboardFocus(true);
+
+    start_time = juce::Time::getMillisecondCounterHiRes() * 0.001;
+    received_points.reserve(OrbitTrailFifo::capacity);
+}
+
+FractalRendererComponent::~FractalRendererComponent()
+{
+    renderService->removeView(this);
+
+    // Tell the context to stop using this Component.
+    attacher.reset();
+    openGLContext.detach();
+}
+
+// Follows the component and its parents, like the context's own attachment does
+class FractalRendererComponent::ContextAttacher : public juce::ComponentMovementWatcher {
+public:
+    explicit ContextAttacher(FractalRendererComponent& o) : juce::ComponentMovementWatcher(&o), owner(o)
     {
-        // No compilation errors - set the shader program to be active
-        shaderProgram->use();
+        owner.updateAttachment();
     }
-    else
-    {
-        // Oops - something went wrong with our shaders!
-        // Check the output window of your IDE to see what the error might be.
-        jassertfalse;
+
+    void componentMovedOrResized(bool, bool) override { owner.updateAttachment(); }
+    void componentPeerChanged() override { owner.updateAttachment(); }
+    void componentVisibilityChanged() override { owner.updateAttachment(); }
+
+private:
+    FractalRendererComponent& owner;
+};
+
+void FractalRendererComponent::updateAttachment()
+{
+    const bool canAttach = isShowing() && !getLocalBounds().isEmpty();
+    if (canAttach == openGLContext.isAttached()) {
+        return;
+    }
+    if (!canAttach) {
+        // Hidden, the next attach picks a context to share with again
+        openGLContext.detach();
+        return;
     }
 
-    juce::OpenGLShaderProgram::Uniform uResolution(*shaderProgram, "iResolution");
-    uResolution.set(getLocalBounds().getWidth(), getLocalBounds().getHeight());
+    // Share GL objects with the other open views, so the programs are only built once.
+    // Picked right before attaching: the native context is created inside attachTo on
+    // this thread, and a member only leaves the group while its own view detaches, on
+    // this thread too, so the context can't close in between. One picked any earlier
+    // may have. With no live context this one starts a group of its own.
+    shareContext = renderService->getShareContext();
+    openGLContext.setNativeSharedContext(shareContext);
+    openGLContext.attachTo(*this);
+}
 
-    juce::OpenGLShaderProgram::Uniform uCam(*shaderProgram, "iCam");
-    uCam.set(cam_x, cam_y);
+void FractalRendererComponent::paint (juce::Graphics& g)
+{
+}
 
-    juce::OpenGLShaderProgram::Uniform uJulia(*shaderProgram, "iJulia");
-    uJulia.set(0.f, 0.f);
+void FractalRendererComponent::resized()
+{
+    // This method is where you should set the bounds of any child
+    // components that your component contains..
 
-    juce::OpenGLShaderProgram::Uniform uZoom(*shaderProgram, "iZoom");
-    uZoom.set(100.f);
+}
 
-    juce::OpenGLShaderProgram::Uniform uType(*shaderProgram, "iType");
-    uType.set(0);
+void FractalRendererComponent::newOpenGLContextCreated()
+{
+    // Generate 1 buffer, using our vbo variable to store its ID.
+    openGLContext.extensions.glGenBuffers(1, &vbo);
 
-    juce::OpenGLShaderProgram::Uniform uIters(*shaderProgram, "iIters");
-    uIters.set(1200);
+    // Generate 1 more buffer, this time using our IBO variable.
+    openGLContext.extensions.glGenBuffers(1, &ibo);
 
-    juce::OpenGLShaderProgram::Uniform uFlags(*shaderProgram, "iFlags");
-    uFlags.set(0x01);
+    // Create 4 vertices each with a different colour.
+    vertexBuffer = {
+        // Vertex 0
+        {
+            { -1.f, 1.f },        // (-1, 1)
+            { 1.f, 0.f, 0.f, 1.f }  // Red
+        },
+        // Vertex 1
+        {
+            { 1.f, 1.f },         // (1, 1)
+            { 1.f, 0.5f, 0.f, 1.f } // Orange
+        },
+        // Vertex 2
+        {
+            { 1.f, -1.f },        // (1, -1)
+            { 1.f, 1.f, 0.f, 1.f }  // Yellow
+        },
+        // Vertex 3
+        {
+            { -1.f, -1.f },       // (-1, -1)
+            { 1.f, 0.f, 1.f, 1.f }  // Purple
+        }
+    };
+
+    // We need 6 indices, 1 for each corner of the two triangles.
+    indexBuffer = {
+        0, 1, 2,
+        0, 2, 3
+    };
+
+    // Bind the VBO.
+    openGLContext.extensions.glBindBuffer(juce::gl::GL_ARRAY_BUFFER, vbo);
+
+    // Send the vertices data.
+    openGLContext.extensions.glBufferData(
+        juce::gl::GL_ARRAY_BUFFER,                        // The type of data we're sending.           
+        sizeof(Vertex) * vertexBuffer.size(),   // The size (in bytes) of the data.
+        vertexBuffer.data(),                    // A pointer to the actual data.
+        juce::gl::GL_STATIC_DRAW                          // How we want the buffer to be drawn.
+    );
+
+    // Bind the IBO.
+    openGLContext.extensions.glBindBuffer(juce::gl::GL_ELEMENT_ARRAY_BUFFER, ibo);
+
+    // Send the indices data.
+    openGLContext.extensions.glBufferData(
+        juce::gl::GL_ELEMENT_ARRAY_BUFFER,
+        sizeof(unsigned int) * indexBuffer.size(),
+        indexBuffer.data(),
+        juce::gl::GL_STATIC_DRAW
+    );
+
+    vertexShader =
+        R"(
+            #version 400 compatibility
+            uniform vec2 iResolution;
+
+            void main() {
+                gl_Position = vec4(gl_Vertex.xy, 0.0, 1.0);
+            }
+        )";
+
+    programs = renderService->joinShareGroup(openGLContext.getRawContext(), shareContext);
+    if (programs == nullptr) {
+        programs = &programCache;
+        programCache.contextCreated();
+    }
 
-    juce::OpenGLShaderProgram::Uniform uTime(*shaderProgram, "iTime");
-    uTime.set(juce::Time::getCurrentTime().getSeconds());
+    trails.contextCreated(PhractalAudioProcessor::num_voices + 2);
+    audioProcessor.getOrbitTrail().setEnabled(true);
 }
 
 void FractalRendererComponent::renderOpenGL()
 {
+    PerfTrace::nameThread("Render");
+    PHRACTAL_TRACE_SCOPE("renderOpenGL");
+    const double frameStart = juce::Time::getMillisecondCounterHiRes();
+
+    if (benchmark != nullptr) {
+        PHRACTAL_TRACE_SCOPE("Benchmark");
+        StepBenchmark();
+    }
+
     // Clear the screen by filling it with black.
     juce::OpenGLHelpers::clear(juce::Colours::black);
 
-    // Tell the renderer to use this shader program
-    shaderProgram->use();
-
     float fpx, fpy, delta_cam_x, delta_cam_y;
     ScreenToPt(cam_x_fp, cam_y_fp, fpx, fpy);
     cam_zoom = cam_zoom * 0.8 + cam_zoom_dest * 0.2;
@@ -402,33 +513,193 @@ void FractalRendererComponent::renderOpenGL()
     const bool hasJulia = (jx < 1e8);
     const bool drawMset = (juliaDrag || !hasJulia);
     const bool drawJset = (juliaDrag || hasJulia);
-    const int flags = (drawMset ? 0x01 : 0) | (drawJset ? 0x02 : 0) | (use_color ? 0x04 : 0);
+    const int flags = (drawMset ? 0x01 : 0) | (drawJset ? 0x02 : 0);
 
-    //juce::OpenGLShaderProgram::Uniform uResolution(*shaderProgram, "iResolution");
-    //uResolution.set(1280.f, 500.f);
+    const int type = audioProcessor.getWaveType();
+    auto latestFormula = audioProcessor.getFormula();
+    if (type != fractal_type || (type == FormulaMap::custom_fractal && latestFormula != formula)) {
+        SetFractal(type);
+    }
+    if (formula != nullptr && latestFormula != formula) {
+        // Formula ids are never reused, so the replaced formula's programs are never
+        // asked for again. Other instances' formulas in the share group are left alone.
+        const int oldId = formula->getId();
+        const juce::ScopedLock sl(renderService->getProgramLock());
+        programs->removeIf([oldId](int key) {
+            return (key >> formula_key_shift) == oldId;
+        });
+    }
+    formula = std::move(latestFormula);
+    const bool custom = (type == FormulaMap::custom_fractal);
 
-    juce::OpenGLShaderProgram::Uniform uCam(*shaderProgram, "iCam");
-    uCam.set(cam_x, cam_y);
+    const bool showLyapunov = lyapunov_mode && LyapunovRenderer::hasExponent(type);
+    if (showLyapunov != lyapunov.isRunning()) {
+        if (showLyapunov) {
+            lyapunov.start();
+        }
+        else {
+            lyapunov.stop();
+        }
+    }
 
-    juce::OpenGLShaderProgram::Uniform uJulia(*shaderProgram, "iJulia");
-    uJulia.set(0.f, 0.f);
+    const bool showDensity = !showLyapunov && density_mode && AttractorDensityRenderer::isAttractor(type);
+    if (showDensity != density.isRunning()) {
+        if (showDensity) {
+            density.start();
+        }
+        else {
+            density.stop();
+        }
+    }
 
-    juce::OpenGLShaderProgram::Uniform uZoom(*shaderProgram, "iZoom");
-    uZoom.set(cam_zoom);
+    if (showLyapunov) {
+        PHRACTAL_TRACE_SCOPE("Lyapunov");
+        DrawLyapunov(type);
+    }
+    else if (showDensity) {
+        PHRACTAL_TRACE_SCOPE("Density");
+        DrawDensity(type, hasJulia);
+    }
+    else {
+        PHRACTAL_TRACE_SCOPE("Fractal");
+        // Load or compile the variant for the current state; nothing is drawn until it's ready,
+        // or while the custom type has no formula
+        const GLuint program = (custom && formula == nullptr) ? 0
+            : GetProgram(programKey(type, use_color, aa_level, use_de, formula.get()), vertexShader, [&] {
+                return buildFragmentShader(type, use_color, aa_level, use_de, formula.get());
+            });
+
+        // Warm up one other fractal type per frame while the driver can compile in the background
+        if (programs->canCompileInBackground()) {
+            const juce::ScopedLock sl(renderService->getProgramLock());
+            for (int t = 0; t < num_fractals; ++t) {
+                if (!programs->contains(programKey(t, use_color, aa_level, use_de))) {
+                    programs->getProgram(programKey(t, use_color, aa_level, use_de), vertexShader, [&] {
+                        return buildFragmentShader(t, use_color, aa_level, use_de);
+                    });
+                    break;
+                }
+            }
+        }
 
-    SetFractal(audioProcessor.getWaveType());
-    juce::OpenGLShaderProgram::Uniform uType(*shaderProgram, "iType");
-    uType.set(audioProcessor.getWaveType());
+        if (program != 0) {
+            juce::gl::glUseProgram(program);
 
-    //juce::OpenGLShaderProgram::Uniform uIters(*shaderProgram, "iIters");
-    //uIters.set(1200);
+            juce::gl::glUniform2f(juce::gl::glGetUniformLocation(program, "iResolution"), getLocalBounds().getWidth(), getLocalBounds().getHeight());
+            juce::gl::glUniform2f(juce::gl::glGetUniformLocation(program, "iCam"), cam_x, cam_y);
+            juce::gl::glUniform2f(juce::gl::glGetUniformLocation(program, "iJulia"), hasJulia ? jx : 0.f, hasJulia ? jy : 0.f);
+            juce::gl::glUniform1f(juce::gl::glGetUniformLocation(program, "iZoom"), cam_zoom);
+            juce::gl::glUniform1i(juce::gl::glGetUniformLocation(program, "iIters"), max_iters);
+            juce::gl::glUniform1i(juce::gl::glGetUniformLocation(program, "iFlags"), flags);
+            juce::gl::glUniform1i(juce::gl::glGetUniformLocation(program, "iTime"), 0);
 
-    juce::OpenGLShaderProgram::Uniform uFlags(*shaderProgram, "iFlags");
-    uFlags.set(flags);
+            DrawQuad();
+        }
+    }
+
+    // Julia set of the c under the mouse, from the atlas, while browsing the parameter plane
+    const bool showJuliaPreview = julia_preview && !hasJulia && !showDensity && !showLyapunov && JuliaAtlas::hasJulia(type);
+    if (showJuliaPreview != juliaAtlas.isRunning()) {
+        if (showJuliaPreview) {
+            juliaAtlas.start();
+        }
+        else {
+            juliaAtlas.stop();
+        }
+    }
+    if (showJuliaPreview) {
+        PHRACTAL_TRACE_SCOPE("Julia preview");
+        DrawJuliaPreview(type);
+    }
 
-    //juce::OpenGLShaderProgram::Uniform uTime(*shaderProgram, "iTime");
-    //uTime.set(juce::Time::getCurrentTime().getSeconds());
+    PHRACTAL_TRACE_SCOPE("Trails");
+    trails.beginFrame();
+    const float now = float(juce::Time::getMillisecondCounterHiRes() * 0.001 - start_time);
+
+    // Orbits of the sounding voices, spread back in time over the points that arrived since the last frame
+    received_points.clear();
+    audioProcessor.getOrbitTrail().pop([this](const OrbitTrailPoint& point) {
+        received_points.push_back(point);
+    });
+    trail_counts.fill(0);
+    for (const auto& point : received_points) {
+        ++trail_counts[point.voice];
+    }
+    if (!received_points.empty()) {
+        last_trail_time = now;
+    }
+    for (const auto& point : received_points) {
+        const float stamp = now - float(--trail_counts[point.voice]) / max_freq;
+        if (point.restart) {
+            trails.restart(point.voice);
+        }
+        trails.push(point.voice, { point.x, point.y, stamp, float(point.voice) });
+    }
 
+    // Preview of the orbit under the mouse, redrawn from its current start point every frame
+    trails.restart(preview_slot);
+    if (!hide_orbit) {
+        float x = orbit_x;
+        float y = orbit_y;
+        trails.push(preview_slot, { x, y, now, -1.0f });
+        float cx = (hasJulia ? jx : px);
+        float cy = (hasJulia ? jy : py);
+        visitMap(type, formula.get(), [&](const auto& map) {
+            CycleDetector detector;
+            detector.reset(x, y);
+            for (int i = 0; i < 200; ++i) {
+                map(x, y, cx, cy);
+                trails.push(preview_slot, { x, y, now, -1.0f });
+                if (x * x + y * y > escape_radius_sq) {
+                    break;
+                }
+                else if (detector.push(x, y) > 0) {
+                    // The whole cycle has been drawn, the rest would overdraw it
+                    break;
+                }
+                else if (i < max_freq / target_fps) {
+                    orbit_x = x;
+                    orbit_y = y;
+                }
+            }
+        });
+    }
+
+    // Outline of the grain region, as the processor has it so a restored one shows too
+    trails.restart(region_slot);
+    const auto region = audioProcessor.getGrainRegion();
+    if (region.active) {
+        const float xs[] = { region.x0, region.x1, region.x1, region.x0, region.x0 };
+        const float ys[] = { region.y0, region.y0, region.y1, region.y1, region.y0 };
+        for (int i = 0; i < 5; ++i) {
+            trails.push(region_slot, { xs[i], ys[i], now, -1.0f });
+        }
+    }
+
+    const GLuint trailProgram = GetProgram(trail_program_key, OrbitTrailRenderer::getVertexShader(), [] {
+        return juce::String(OrbitTrailRenderer::getFragmentShader());
+    });
+    if (trailProgram != 0) {
+        juce::gl::glUseProgram(trailProgram);
+        juce::gl::glUniform2f(juce::gl::glGetUniformLocation(trailProgram, "iResolution"), getLocalBounds().getWidth(), getLocalBounds().getHeight());
+        juce::gl::glUniform2f(juce::gl::glGetUniformLocation(trailProgram, "iCam"), cam_x, cam_y);
+        juce::gl::glUniform1f(juce::gl::glGetUniformLocation(trailProgram, "iZoom"), cam_zoom);
+        juce::gl::glUniform1f(juce::gl::glGetUniformLocation(trailProgram, "iNow"), now);
+        juce::gl::glUniform1f(juce::gl::glGetUniformLocation(trailProgram, "iFade"), trail_fade_seconds);
+
+        juce::gl::glEnable(juce::gl::GL_BLEND);
+        juce::gl::glBlendFunc(juce::gl::GL_SRC_ALPHA, juce::gl::GL_ONE_MINUS_SRC_ALPHA);
+        juce::gl::glLineWidth(1.0f);
+        trails.draw();
+        juce::gl::glDisable(juce::gl::GL_BLEND);
+    }
+
+    // What this view costs the render service's frame budget
+    lastFrameMs = float(juce::Time::getMillisecondCounterHiRes() - frameStart);
+}
+
+void FractalRendererComponent::DrawQuad()
+{
     openGLContext.extensions.glBindBuffer(juce::gl::GL_ARRAY_BUFFER, vbo);
     openGLContext.extensions.glBindBuffer(juce::gl::GL_ELEMENT_ARRAY_BUFFER, ibo);
 
@@ -472,46 +743,191 @@ void FractalRendererComponent::renderOpenGL()
 
     openGLContext.extensions.glDisableVertexAttribArray(0);
     openGLContext.extensions.glDisableVertexAttribArray(1);
+}
 
-    if (!hide_orbit) {
-        juce::gl::glLineWidth(1.0f);
-        juce::gl::glColor3f(1.0f, 0.0f, 0.0f);
-        juce::gl::glBegin(juce::gl::GL_LINE_STRIP);
-        int sx, sy;
-        float x = orbit_x;
-        float y = orbit_y;
-        PtToScreen(x, y, sx, sy);
-        juce::gl::glVertex2i(sx, sy);
-        float cx = (hasJulia ? jx : px);
-        float cy = (hasJulia ? jy : py);
-        for (int i = 0; i < 200; ++i) {
-            fractal(x, y, cx, cy);
-            PtToScreen(x, y, sx, sy);
-            juce::gl::glVertex2i(sx, sy);
-            if (x * x + y * y > escape_radius_sq) {
-                break;
-            }
-            else if (i < max_freq / target_fps) {
-                orbit_x = x;
-                orbit_y = y;
+void FractalRendererComponent::DrawDensity(int type, bool hasJulia)
+{
+    // The map constant is the one the voices play: the Julia point, the picked point,
+    // or a known attractor until a point has been picked
+    FractalView view = GetView();
+    view.type = type;
+    if (hasJulia) {
+        view.jx = jx;
+        view.jy = jy;
+    }
+    else if (has_point) {
+        view.jx = px;
+        view.jy = py;
+    }
+    else {
+        AttractorDensityRenderer::getDefaultParameter(type, view.jx, view.jy);
+    }
+    density.setView(view);
+
+    int width, height;
+    if (density.getImage(densityPixels, width, height)) {
+        densityTexture.loadARGB(densityPixels.data(), width, height);
+    }
+    DrawTexture(densityTexture);
+}
+
+void FractalRendererComponent::DrawLyapunov(int type)
+{
+    FractalView view = GetView();
+    view.type = type;
+    lyapunov.setView(view);
+
+    int width, height;
+    if (lyapunov.getImage(lyapunovPixels, width, height)) {
+        lyapunovTexture.loadARGB(lyapunovPixels.data(), width, height);
+    }
+    DrawTexture(lyapunovTexture);
+}
+
+void FractalRendererComponent::DrawJuliaPreview(int type)
+{
+    float cx, cy;
+    ScreenToPt(mousePos.x, mousePos.y, cx, cy);
+    juliaAtlas.setType(type);
+    juliaAtlas.setFocus(cx, cy);
+
+    // The whole atlas only when the map changes, otherwise just the new tiles
+    if (juliaAtlas.takeUpdate(juliaAtlasUpdate, juliaAtlasTexture.getTextureID() == 0)) {
+        const int size = JuliaAtlas::atlas_size;
+        const int tileSize = JuliaAtlas::tile_size;
+        if (juliaAtlasUpdate.whole) {
+            juliaAtlasTexture.loadARGB(juliaAtlasUpdate.pixels.data(), size, size);
+        }
+        else {
+            // Rows in the same order loadARGB gave them
+            juliaAtlasTexture.bind();
+            for (size_t i = 0; i < juliaAtlasUpdate.tiles.size(); ++i) {
+                const int index = juliaAtlasUpdate.tiles[i];
+                juce::gl::glTexSubImage2D(juce::gl::GL_TEXTURE_2D, 0,
+                    (index % JuliaAtlas::grid_size) * tileSize, (index / JuliaAtlas::grid_size) * tileSize, tileSize, tileSize,
+                    juce::gl::GL_BGRA, juce::gl::GL_UNSIGNED_BYTE, juliaAtlasUpdate.pixels.data() + i * tileSize * tileSize);
             }
+            juliaAtlasTexture.unbind();
         }
-        juce::gl::glEnd();
+    }
+    juce::Rectangle<float> tile;
+    if (juliaAtlasTexture.getTextureID() == 0 || !juliaAtlas.findTile(cx, cy, tile)) {
+        return;
+    }
+
+    const GLuint program = GetProgram(julia_tile_program_key, density_vertex_shader, [] {
+        return juce::String(julia_tile_fragment_shader);
+    });
+    if (program == 0) {
+        return;
+    }
+
+    // Inset in the top right corner of whatever the context's viewport is
+    GLint viewport[4];
+    juce::gl::glGetIntegerv(juce::gl::GL_VIEWPORT, viewport);
+    const int size = juce::jmin(viewport[2], viewport[3]) / 4;
+    const int margin = size / 16;
+    juce::gl::glViewport(viewport[0] + viewport[2] - size - margin, viewport[1] + viewport[3] - size - margin, size, size);
+
+    juce::gl::glUseProgram(program);
+    juce::gl::glActiveTexture(juce::gl::GL_TEXTURE0);
+    juliaAtlasTexture.bind();
+    juce::gl::glUniform1i(juce::gl::glGetUniformLocation(program, "iAtlas"), 0);
+    juce::gl::glUniform4f(juce::gl::glGetUniformLocation(program, "iTile"), tile.getX(), tile.getY(), tile.getWidth(), tile.getHeight());
+    DrawQuad();
+    juliaAtlasTexture.unbind();
+
+    juce::gl::glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+}
+
+void FractalRendererComponent::DrawTexture(juce::OpenGLTexture& texture)
+{
+    if (texture.getTextureID() == 0) {
+        return;
+    }
+
+    const GLuint program = GetProgram(density_program_key, density_vertex_shader, [] {
+        return juce::String(density_fragment_shader);
+    });
+    if (program != 0) {
+        juce::gl::glUseProgram(program);
+        juce::gl::glActiveTexture(juce::gl::GL_TEXTURE0);
+        texture.bind();
+        juce::gl::glUniform1i(juce::gl::glGetUniformLocation(program, "iDensity"), 0);
+        DrawQuad();
+        texture.unbind();
     }
 }
 
 void FractalRendererComponent::openGLContextClosing()
 {
+    if (benchmark != nullptr || benchmark_running) {
+        // Its framebuffer belongs to this context
+        benchmark.reset();
+        juce::Component::SafePointer<FractalRendererComponent> safeThis(this);
+        juce::MessageManager::callAsync([safeThis] {
+            if (safeThis != nullptr) {
+                safeThis->benchmark_running = false;
+            }
+        });
+    }
+    density.stop();
+    densityTexture.release();
+    lyapunov.stop();
+    lyapunovTexture.release();
+    juliaAtlas.stop();
+    juliaAtlasTexture.release();
+    audioProcessor.getOrbitTrail().setEnabled(false);
+    trails.release();
+    if (programs == &programCache) {
+        programCache.release();
+    }
+    else {
+        renderService->leaveShareGroup(openGLContext.getRawContext());
+    }
+    programs = &programCache;
+}
+
+GLuint FractalRendererComponent::GetProgram(int key, const juce::String& vertexSource, const std::function<juce::String()>& makeFragmentSource)
+{
+    const juce::ScopedLock sl(renderService->getProgramLock());
+    return programs->getProgram(key, vertexSource, makeFragmentSource);
+}
+
+FractalRenderService::View::Priority FractalRendererComponent::getRenderPriority()
+{
+    if (!isShowing()) {
+        return hidden;
+    }
+
+    // Anything that changes from one frame to the next needs the full frame rate
+    const bool cameraMoving = std::abs(cam_zoom - cam_zoom_dest) > 1e-3f * cam_zoom
+        || std::abs(cam_x - cam_x_dest) * cam_zoom > 0.1f
+        || std::abs(cam_y - cam_y_dest) * cam_zoom > 0.1f;
+    const float now = float(juce::Time::getMillisecondCounterHiRes() * 0.001 - start_time);
+    const bool trailsShowing = (now - last_trail_time.load() < trail_fade_seconds);
+
+    if (leftPressed || dragging || juliaDrag || regionDrag || !hide_orbit || cameraMoving || trailsShowing || density.isRunning() || lyapunov.isRefining()
+        || benchmark_running
+        || (julia_preview && now - last_hover_time < hover_seconds)) {
+        return animating;
+    }
+    return still;
+}
+
+void FractalRendererComponent::renderFrame()
+{
+    openGLContext.triggerRepaint();
 }
 
 void FractalRendererComponent::mouseMove(const juce::MouseEvent& event)
 {
+    PHRACTAL_TRACE_SCOPE("mouseMove");
     mousePos = event.getPosition();
+    last_hover_time = float(juce::Time::getMillisecondCounterHiRes() * 0.001 - start_time);
     if (leftPressed) {
         ScreenToPt(mousePos.x, mousePos.y, px, py);
-        //synth.SetPoint(px, py);
-        orbit_x = px;
-        orbit_y = py;
+        SetPoint(px, py);
     }
     if (dragging) {
         juce::Point<float> curDrag(mousePos.x, mousePos.y);
@@ -528,13 +944,19 @@ void FractalRendererComponent::mouseMove(const juce::MouseEvent& event)
 
 void FractalRendererComponent::mouseDown(const juce::MouseEvent& event)
 {
-    if (event.mods.isLeftButtonDown()) {
+    PHRACTAL_TRACE_SCOPE("mouseDown");
+    if (event.mods.isLeftButtonDown() && event.mods.isShiftDown()) {
+        regionDrag = true;
+        ScreenToPt(mousePos.x, mousePos.y, region_x0, region_y0);
+        region_x1 = region_x0;
+        region_y1 = region_y0;
+    }
+    else if (event.mods.isLeftButtonDown()) {
         leftPressed = true;
         hide_orbit = false;
+        has_point = true;
         ScreenToPt(mousePos.x, mousePos.y, px, py);
-        //synth.SetPoint(px, py);
-        orbit_x = px;
-        orbit_y = py;
+        SetPoint(px, py);
     }
     else if (event.mods.isMiddleButtonDown()) {
         prevDrag = juce::Point<float>(mousePos.x, mousePos.y);
@@ -546,8 +968,25 @@ void FractalRendererComponent::mouseDown(const juce::MouseEvent& event)
     }
 }
 
+void FractalRendererComponent::mouseDrag(const juce::MouseEvent& event)
+{
+    if (regionDrag) {
+        mousePos = event.getPosition();
+        ScreenToPt(mousePos.x, mousePos.y, region_x1, region_y1);
+        audioProcessor.setGrainRegion(region_x0, region_y0, region_x1, region_y1);
+    }
+}
+
 void FractalRendererComponent::mouseUp(const juce::MouseEvent& event)
 {
+    PHRACTAL_TRACE_SCOPE("mouseUp");
+    if (regionDrag && !event.mods.isLeftButtonDown()) {
+        regionDrag = false;
+        // A click without a drag goes back to grains around the orbit point
+        if (region_x0 == region_x1 || region_y0 == region_y1) {
+            audioProcessor.clearGrainRegion();
+        }
+    }
     if (!event.mods.isLeftButtonDown()) {
         leftPressed = false;
     }
@@ -558,6 +997,7 @@ void FractalRendererComponent::mouseUp(const juce::MouseEvent& event)
 
 void FractalRendererComponent::mouseWheelMove(const juce::MouseEvent& event, const juce::MouseWheelDetails& wheel)
 {
+    PHRACTAL_TRACE_SCOPE("mouseWheelMove");
     cam_zoom_dest *= std::pow(1.1f, wheel.deltaY);
     cam_x_fp = mousePos.x;
     cam_y_fp = mousePos.y;
@@ -565,6 +1005,7 @@ void FractalRendererComponent::mouseWheelMove(const juce::MouseEvent& event, con
 
 bool FractalRendererComponent::keyPressed(const juce::KeyPress& key)
 {
+    PHRACTAL_TRACE_SCOPE("keyPressed");
     if (key.getTextCharacter() == 'r') {
         cam_x = cam_x_dest = 0.0;
         cam_y = cam_y_dest = 0.0;
@@ -582,6 +1023,59 @@ bool FractalRendererComponent::keyPressed(const juce::KeyPress& key)
         hide_orbit = true;
         frame = 0;
     }
+    else if (key.getTextCharacter() == 'e') {
+        ExportPoster();
+    }
+    else if (key.getTextCharacter() == 'k') {
+        // Current view as the next keyframe of the zoom path
+        zoomPath.add(GetView());
+    }
+    else if (key.getTextCharacter() == 'l') {
+        zoomPath.clear();
+    }
+    else if (key.getTextCharacter() == 'v') {
+        RenderZoomPath();
+    }
+    else if (key.getTextCharacter() == 'm') {
+        // Orbit density of the attractor maps instead of escape time
+        density_mode = !density_mode;
+        frame = 0;
+    }
+    else if (key.getTextCharacter() == 'y') {
+        // Lyapunov exponents over the c plane of the attractor maps
+        lyapunov_mode = !lyapunov_mode;
+        hide_orbit = true;
+        frame = 0;
+    }
+    else if (key.getTextCharacter() == 'p') {
+        // Julia preview of the c under the mouse
+        julia_preview = !julia_preview;
+    }
+    else if (key.getTextCharacter() == 'c') {
+        use_color = !use_color;
+        frame = 0;
+    }
+    else if (key.getTextCharacter() == 'a') {
+        // Cycle through 1, 4 and 8 samples per pixel
+        aa_level = (aa_level == 1 ? 4 : aa_level == 4 ? 8 : 1);
+        frame = 0;
+    }
+    else if (key.getTextCharacter() == 'd') {
+        use_de = !use_de;
+        frame = 0;
+    }
+    else if (key.getTextCharacter() == 't') {
+        ToggleTrace();
+    }
+    else if (key.getTextCharacter() == 'b') {
+        RunBenchmark();
+    }
+    else if (key.getTextCharacter() == 'g') {
+        audioProcessor.clearGrainRegion();
+    }
+    else if (key.getTextCharacter() == 'w') {
+        ToggleRecording();
+    }
     return false;
 }
 
@@ -593,3 +1087,278 @@ bool FractalRendererComponent::keyStateChanged(bool isKeyDown)
     }
     return false;
 }
+
+FractalView FractalRendererComponent::GetView() const
+{
+    FractalView view;
+    view.type = fractal_type < 0 ? 0 : fractal_type;
+    if (view.type == FormulaMap::custom_fractal) {
+        view.formula = formula;
+    }
+    view.cam_x = cam_x;
+    view.cam_y = cam_y;
+    view.cam_zoom = cam_zoom;
+    view.julia = (jx < 1e8);
+    view.jx = jx;
+    view.jy = jy;
+    view.use_color = use_color;
+    view.width = getWidth();
+    view.height = getHeight();
+    return view;
+}
+
+void FractalRendererComponent::ExportPoster()
+{
+    static const int widths[] = { 4096, 8192, 16384, 32768 };
+
+    juce::PopupMenu menu;
+    menu.addSectionHeader("PNG");
+    for (int i = 0; i < 4; ++i) {
+        menu.addItem(i + 1, juce::String(widths[i]) + " px wide");
+    }
+    menu.addSectionHeader("PNG + float32 escape data");
+    for (int i = 0; i < 4; ++i) {
+        menu.addItem(i + 101, juce::String(widths[i]) + " px wide");
+    }
+
+    const auto view = GetView();
+    menu.showMenuAsync(juce::PopupMenu::Options(), [this, view](int result) {
+        if (result == 0 || view.width <= 0) {
+            return;
+        }
+        const bool escapeData = (result > 100);
+        const int width = widths[(result - 1) % 100];
+        const int height = juce::roundToInt(double(width) * view.height / view.width);
+        const auto poster = view.scaledTo(width, height);
+
+        fileChooser = std::make_unique<juce::FileChooser>("Export poster",
+            juce::File::getSpecialLocation(juce::File::userPicturesDirectory).getChildFile("Phractal.png"), "*.png");
+        const int flags = juce::FileBrowserComponent::saveMode
+            | juce::FileBrowserComponent::canSelectFiles
+            | juce::FileBrowserComponent::warnAboutOverwriting;
+        fileChooser->launchAsync(flags, [poster, escapeData](const juce::FileChooser& chooser) {
+            const auto file = chooser.getResult();
+            if (file != juce::File()) {
+                (new PosterExporter(poster, file.withFileExtension("png"), escapeData))->launchThread();
+            }
+        });
+    });
+}
+
+void FractalRendererComponent::ToggleTrace()
+{
+    if (!PerfTrace::isCapturing()) {
+        if (!PerfTrace::start()) {
+            juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::InfoIcon,
+                "Trace", "The last trace is still being written.");
+        }
+        return;
+    }
+    PerfTrace::stop();
+
+    fileChooser = std::make_unique<juce::FileChooser>("Save trace",
+        juce::File::getSpecialLocation(juce::File::userDocumentsDirectory).getChildFile("Phractal trace.json"), "*.json");
+    const int flags = juce::FileBrowserComponent::saveMode
+        | juce::FileBrowserComponent::canSelectFiles
+        | juce::FileBrowserComponent::warnAboutOverwriting;
+    fileChooser->launchAsync(flags, [](const juce::FileChooser& chooser) {
+        const auto chosen = chooser.getResult();
+        if (chosen == juce::File()) {
+            return;
+        }
+        const auto file = chosen.withFileExtension("json");
+        PerfTrace::write(file, [file](bool ok) {
+            if (!ok) {
+                juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon,
+                    "Save trace", "Couldn't write " + file.getFullPathName());
+            }
+        });
+    });
+}
+
+void FractalRendererComponent::ToggleRecording()
+{
+    auto& recorder = audioProcessor.getRecorder();
+    if (recorder.isRecording()) {
+        recorder.stop();
+        const auto droppedSamples = recorder.getDroppedSamples();
+        const auto droppedPoints = recorder.getDroppedPoints();
+        if (droppedSamples > 0 || droppedPoints > 0) {
+            juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon, "Recording",
+                "The disk didn't keep up: " + juce::String(droppedSamples) + " samples and "
+                + juce::String(droppedPoints) + " orbit points were dropped.");
+        }
+        return;
+    }
+
+    fileChooser = std::make_unique<juce::FileChooser>("Record performance",
+        juce::File::getSpecialLocation(juce::File::userDocumentsDirectory).getChildFile("Phractal performance.wav"), "*.wav");
+    const int flags = juce::FileBrowserComponent::saveMode
+        | juce::FileBrowserComponent::canSelectFiles
+        | juce::FileBrowserComponent::warnAboutOverwriting;
+    juce::Component::SafePointer<FractalRendererComponent> safeThis(this);
+    fileChooser->launchAsync(flags, [safeThis](const juce::FileChooser& chooser) {
+        const auto file = chooser.getResult();
+        if (safeThis == nullptr || file == juce::File()) {
+            return;
+        }
+        auto& processor = safeThis->audioProcessor;
+        juce::String error;
+        if (!processor.getRecorder().start(file.withFileExtension("wav"), processor.getSampleRate(),
+                PhractalAudioProcessor::num_voices, error)) {
+            juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon, "Recording", error);
+        }
+    });
+}
+
+void FractalRendererComponent::RunBenchmark()
+{
+    if (benchmark_running) {
+        return;
+    }
+
+    fileChooser = std::make_unique<juce::FileChooser>("Choose the benchmark reference folder", benchmarkReference);
+    const int flags = juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectDirectories;
+    juce::Component::SafePointer<FractalRendererComponent> safeThis(this);
+    fileChooser->launchAsync(flags, [safeThis](const juce::FileChooser& chooser) {
+        const auto folder = chooser.getResult();
+        if (safeThis == nullptr || folder == juce::File() || safeThis->benchmark_running) {
+            return;
+        }
+        safeThis->benchmarkReference = folder;
+        safeThis->benchmark_running = true;
+
+        // The GLSL frames go first, a case per frame on the GL thread, then the
+        // CPU renders and the comparison run in the background
+        auto* self = safeThis.getComponent();
+        self->openGLContext.executeOnGLThread([self, folder](juce::OpenGLContext&) {
+            self->benchmark = std::make_unique<BenchmarkPass>();
+            self->benchmark->reference = folder;
+            self->benchmark->cases = RenderBenchmark::getCases();
+            self->benchmark->frames.resize(self->benchmark->cases.size());
+        }, false);
+    });
+}
+
+void FractalRendererComponent::StepBenchmark()
+{
+    using namespace juce::gl;
+    auto& pass = *benchmark;
+    const int width = RenderBenchmark::width;
+    const int height = RenderBenchmark::height;
+
+    if (!pass.target.isValid() && !pass.target.initialise(openGLContext, width, height)) {
+        // No GLSL timings, the CPU half still runs
+        pass.next = pass.cases.size();
+    }
+
+    if (pass.next < pass.cases.size()) {
+        const auto& view = pass.cases[pass.next].view;
+
+        // A background compile is waited out over the next frames, the benchmark shouldn't time it
+        const GLuint program = GetProgram(programKey(view.type, false, 1, false), vertexShader, [&] {
+            return buildFragmentShader(view.type, false, 1, false);
+        });
+        if (program == 0 && ++pass.waitedFrames < max_benchmark_wait_frames) {
+            return;
+        }
+        auto& result = pass.frames[pass.next];
+        ++pass.next;
+        pass.waitedFrames = 0;
+
+        if (program != 0) {
+            GLint viewport[4];
+            glGetIntegerv(GL_VIEWPORT, viewport);
+            pass.target.makeCurrentRenderingTarget();
+            glViewport(0, 0, width, height);
+            glUseProgram(program);
+            glUniform2f(glGetUniformLocation(program, "iResolution"), float(width), float(height));
+            glUniform2f(glGetUniformLocation(program, "iCam"), view.cam_x, view.cam_y);
+            glUniform2f(glGetUniformLocation(program, "iJulia"), view.jx, view.jy);
+            glUniform1f(glGetUniformLocation(program, "iZoom"), view.cam_zoom);
+            glUniform1i(glGetUniformLocation(program, "iIters"), view.iters);
+            glUniform1i(glGetUniformLocation(program, "iFlags"), 0x01);
+            glUniform1i(glGetUniformLocation(program, "iTime"), 0);
+
+            glFinish();
+            const double start = juce::Time::getMillisecondCounterHiRes();
+            for (int f = 0; f < RenderBenchmark::frames_per_case; ++f) {
+                DrawQuad();
+                glFinish();
+            }
+            result.ms = (juce::Time::getMillisecondCounterHiRes() - start) / RenderBenchmark::frames_per_case;
+
+            // GL rows run bottom up, the CPU renderer's top down
+            pass.rgba.resize(size_t(width) * height * 4);
+            glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pass.rgba.data());
+            pass.target.releaseAsRenderingTarget();
+            glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+            result.rgb.resize(size_t(width) * height * 3);
+            for (int y = 0; y < height; ++y) {
+                const juce::uint8* src = pass.rgba.data() + size_t(height - 1 - y) * width * 4;
+                juce::uint8* dst = result.rgb.data() + size_t(y) * width * 3;
+                for (int x = 0; x < width; ++x) {
+                    dst[x * 3 + 0] = src[x * 4 + 0];
+                    dst[x * 3 + 1] = src[x * 4 + 1];
+                    dst[x * 3 + 2] = src[x * 4 + 2];
+                }
+            }
+        }
+        if (pass.next < pass.cases.size()) {
+            return;
+        }
+    }
+
+    juce::Component::SafePointer<FractalRendererComponent> safeThis(this);
+    juce::MessageManager::callAsync([safeThis, reference = pass.reference, frames = std::move(pass.frames)]() mutable {
+        if (safeThis != nullptr) {
+            safeThis->benchmark_running = false;
+            (new RenderBenchmark(reference, RenderBenchmark::getDefaultDirectory(), std::move(frames)))->launchThread();
+        }
+    });
+    benchmark.reset();
+}
+
+void FractalRendererComponent::RenderZoomPath()
+{
+    static const int sizes[][2] = { { 1280, 720 }, { 1920, 1080 }, { 3840, 2160 } };
+
+    if (zoomPath.size() < 2) {
+        juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::InfoIcon,
+            "Zoom path", "Add at least two keyframes with 'k' first ('l' clears them).");
+        return;
+    }
+
+    juce::PopupMenu menu;
+    menu.addSectionHeader("PNG sequence");
+    for (int i = 0; i < 3; ++i) {
+        menu.addItem(i + 1, juce::String(sizes[i][0]) + " x " + juce::String(sizes[i][1]));
+    }
+    menu.addSectionHeader("Raw rgb24 video");
+    for (int i = 0; i < 3; ++i) {
+        menu.addItem(i + 101, juce::String(sizes[i][0]) + " x " + juce::String(sizes[i][1]));
+    }
+
+    menu.showMenuAsync(juce::PopupMenu::Options(), [this](int result) {
+        if (result == 0) {
+            return;
+        }
+        const bool rawVideo = (result > 100);
+        const int width = sizes[(result - 1) % 100][0];
+        const int height = sizes[(result - 1) % 100][1];
+        const auto path = zoomPath;
+
+        fileChooser = std::make_unique<juce::FileChooser>("Render zoom path",
+            juce::File::getSpecialLocation(juce::File::userMoviesDirectory).getChildFile(rawVideo ? "Phractal.rgb" : "Phractal.png"),
+            rawVideo ? "*.rgb" : "*.png");
+        const int flags = juce::FileBrowserComponent::saveMode
+            | juce::FileBrowserComponent::canSelectFiles
+            | juce::FileBrowserComponent::warnAboutOverwriting;
+        fileChooser->launchAsync(flags, [path, width, height, rawVideo](const juce::FileChooser& chooser) {
+            const auto file = chooser.getResult();
+            if (file != juce::File()) {
+                (new ZoomPathRenderer(path, file.withFileExtension(rawVideo ? "rgb" : "png"), width, height, rawVideo))->launchThread();
+            }
+        });
+    });
+}
@@ -12,47 +12,32 @@
 
 #include <JuceHeader.h>
 #include "../PluginProcessor.h"
+#include "../Data/FractalMaps.h"
+#include "../Data/CycleDetector.h"
+#include "../Data/PerfTrace.h"
+#include "ShaderProgramCache.h"
+#include "FractalRenderService.h"
+#include "OrbitTrailRenderer.h"
+#include "../Render/EscapeTimeRenderer.h"
+#include "../Render/AttractorDensityRenderer.h"
+#include "../Render/LyapunovRenderer.h"
+#include "../Render/JuliaAtlas.h"
+#include "../Render/ZoomPath.h"
+#include "../Render/RenderBenchmark.h"
 
 static const int target_fps = 60;
-static const int sample_rate = 48000;
-static const int max_freq = 4000;
 static const int window_w_init = 1280;
 static const int window_h_init = 720;
 static const int starting_fractal = 0;
-static const int max_iters = 1200;
-static const double escape_radius_sq = 1000.0;
 static const char window_name[] = "Fractal Sound Explorer";
 
-void mandelbrot(float& x, float& y, float cx, float cy);
-void burning_ship(float& x, float& y, float cx, float cy);
-void feather(float& x, float& y, float cx, float cy);
-void sfx(float& x, float& y, float cx, float cy);
-void henon(float& x, float& y, float cx, float cy);
-void duffing(float& x, float& y, float cx, float cy);
-void ikeda(float& x, float& y, float cx, float cy);
-void chirikov(float& x, float& y, float cx, float cy);
-
-typedef void (*Fractal)(float&, float&, float, float);
-static Fractal fractal = nullptr;
-
-static const Fractal all_fractals[] = {
-    mandelbrot,
-    burning_ship,
-    feather,
-    sfx,
-    henon,
-    duffing,
-    ikeda,
-    chirikov,
-};
-
 //==============================================================================
 /*
 */
-class FractalRendererComponent  : public juce::Component, public juce::OpenGLRenderer
+class FractalRendererComponent  : public juce::Component, public juce::OpenGLRenderer, public FractalRenderService::View
 {
 public:
-    FractalRendererComponent(const PhractalAudioProcessor& pap);
+    FractalRendererComponent(PhractalAudioProcessor& pap);
     ~FractalRendererComponent() override;
 
     void paint (juce::Graphics&) override;
@@ -62,8 +47,12 @@ public:
     void renderOpenGL() override;
     void openGLContextClosing() override;
 
+    Priority getRenderPriority() override;
+    void renderFrame() override;
+
     void mouseMove(const juce::MouseEvent& event) override;
     void mouseDown(const juce::MouseEvent& event) override;
+    void mouseDrag(const juce::MouseEvent& event) override;
     void mouseUp(const juce::MouseEvent& event) override;
     void mouseWheelMove(const juce::MouseEvent& event, const juce::MouseWheelDetails& wheel) override;
     bool keyPressed(const juce::KeyPress& key) override;
@@ -78,18 +67,60 @@ public:
         y = int(cam_zoom * (py + cam_y)) + getLocalBounds().getHeight() / 2;
     }
 
+    FractalView GetView() const;
+    void ExportPoster();
+    void RenderZoomPath();
+    // Starts a trace capture, or stops it and asks where to save it
+    void ToggleTrace();
+    void RunBenchmark();
+    // Asks where to record the performance to and starts, or stops the recording
+    void ToggleRecording();
+
+    void SetPoint(float x, float y) {
+        if (lyapunov_mode && LyapunovRenderer::hasExponent(fractal_type)) {
+            // The Lyapunov plane is c, the orbit starts where the exponents were measured from
+            orbit_x = LyapunovRenderer::start_x;
+            orbit_y = LyapunovRenderer::start_y;
+            audioProcessor.setOrbitPoint(orbit_x, orbit_y, x, y);
+            return;
+        }
+        const bool hasJulia = (jx < 1e8);
+        audioProcessor.setOrbitPoint(x, y, hasJulia ? jx : x, hasJulia ? jy : y);
+        orbit_x = x;
+        orbit_y = y;
+    }
+
     void SetFractal(int type) {
         jx = jy = 1e8;
-        fractal = all_fractals[type];
+        fractal_type = type;
         normalized = (type == 0);
         hide_orbit = true;
+        has_point = false;
         frame = 0;
     }
 
 private:
-    const PhractalAudioProcessor& audioProcessor;
-
+    class ContextAttacher;
+    // Attaches the context while the component is showing and detaches it otherwise
+    void updateAttachment();
+
+    void DrawQuad();
+    void DrawDensity(int type, bool hasJulia);
+    void DrawLyapunov(int type);
+    void DrawJuliaPreview(int type);
+    // Full-view image, row 0 at the top
+    void DrawTexture(juce::OpenGLTexture& texture);
+    // GL thread. Renders the next case of a running benchmark, one per frame.
+    void StepBenchmark();
+    GLuint GetProgram(int key, const juce::String& vertexSource, const std::function<juce::String()>& makeFragmentSource);
+
+    PhractalAudioProcessor& audioProcessor;
+
+    juce::SharedResourcePointer<FractalRenderService> renderService;
     juce::OpenGLContext openGLContext;
+    // The live context this one was created to share with, if any
+    void* shareContext = nullptr;
+    std::unique_ptr<ContextAttacher> attacher;
 
     struct Vertex
     {
@@ -104,9 +135,40 @@ private:
     GLuint ibo; // Index buffer object.
 
     juce::String vertexShader;
-    juce::String fragmentShader;
 
-    std::unique_ptr<juce::OpenGLShaderProgram> shaderProgram;
+    // The render service's shared cache, or programCache if this context couldn't join its group
+    ShaderProgramCache programCache;
+    ShaderProgramCache* programs = &programCache;
+
+    // One trail per voice, plus the preview orbit under the mouse
+    OrbitTrailRenderer trails;
+    static const int preview_slot = PhractalAudioProcessor::num_voices;
+    static const int region_slot = PhractalAudioProcessor::num_voices + 1;
+    std::vector<OrbitTrailPoint> received_points;
+    std::array<int, PhractalAudioProcessor::num_voices> trail_counts;
+    double start_time = 0.0;
+    std::atomic<float> last_trail_time { -1e9f };
+
+    // Orbit density view of the attractor maps
+    AttractorDensityRenderer density;
+    juce::OpenGLTexture densityTexture;
+    std::vector<juce::PixelARGB> densityPixels;
+    bool density_mode = false;
+
+    // Lyapunov exponents over the c plane of the attractor maps
+    LyapunovRenderer lyapunov;
+    juce::OpenGLTexture lyapunovTexture;
+    std::vector<juce::PixelARGB> lyapunovPixels;
+    bool lyapunov_mode = false;
+
+    // Julia thumbnails over a grid of c, shown for the c under the mouse
+    JuliaAtlas juliaAtlas;
+    juce::OpenGLTexture juliaAtlasTexture;
+    JuliaAtlas::Update juliaAtlasUpdate;
+    bool julia_preview = true;
+    // Frames keep coming this long after the mouse last moved, so the preview follows it
+    static constexpr float hover_seconds = 0.25f;
+    float last_hover_time = -1e9f;
 
     juce::Point<int> mousePos;
     float cam_x = 0.0;
@@ -119,16 +181,48 @@ private:
     float cam_zoom_dest = cam_zoom;
     bool normalized = true;
     bool use_color = false;
+    int aa_level = 1;
+    bool use_de = false;
     bool hide_orbit = true;
     float jx = 1e8;
     float jy = 1e8;
     int frame = 0;
+    int fractal_type = -1;
+    // The processor's current formula, for the custom type
+    std::shared_ptr<const FormulaMap> formula;
 
     float px, py, orbit_x, orbit_y;
+    bool has_point = false;
     bool leftPressed = false;
     bool dragging = false;
     bool juliaDrag = false;
     juce::Point<float> prevDrag;
 
+    // The corners of the grain region being dragged out with shift, message
+    // thread only; the GL thread draws the processor's copy
+    bool regionDrag = false;
+    float region_x0 = 0.0f, region_y0 = 0.0f;
+    float region_x1 = 0.0f, region_y1 = 0.0f;
+
+    std::unique_ptr<juce::FileChooser> fileChooser;
+
+    // The GLSL half of a running benchmark, GL thread only
+    struct BenchmarkPass {
+        juce::File reference;
+        std::vector<RenderBenchmark::Case> cases;
+        std::vector<RenderBenchmark::GpuFrame> frames;
+        size_t next = 0;
+        int waitedFrames = 0;
+        juce::OpenGLFrameBuffer target;
+        std::vector<juce::uint8> rgba;
+    };
+    std::unique_ptr<BenchmarkPass> benchmark;
+    // A case whose program still isn't compiled after this many frames has no GLSL timing
+    static const int max_benchmark_wait_frames = 300;
+    // Set on the message thread from when the reference folder is chosen until the CPU half is launched
+    std::atomic<bool> benchmark_running { false };
+    juce::File benchmarkReference = juce::File::getSpecialLocation(juce::File::userDocumentsDirectory);
+    ZoomPath zoomPath;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FractalRendererComponent)
 };
@@ -0,0 +1,56 @@
+/*
+  ==============================================================================
+
+    GrainComponent.cpp
+    Created: 27 Oct 2026 5:06:51pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "GrainComponent.h"
+
+//==============================================================================
+GrainComponent::GrainComponent(juce::AudioProcessorValueTreeState& apvts)
+{
+    if (auto* choice = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter("ENGINE"))) {
+        engineSelector.addItemList(choice->choices, 1);
+    }
+    addAndMakeVisible(engineSelector);
+    engineAttachment = std::make_unique<ComboBoxAttachment>(apvts, "ENGINE", engineSelector);
+
+    const char* const knobIds[] = { "GRAINSIZE", "GRAINDENSITY", "GRAINJITTER", "GRAINSPREAD" };
+    const char* const knobNames[] = { "Size", "Density", "Jitter", "Spread" };
+    for (size_t i = 0; i < knobs.size(); ++i) {
+        knobs[i].setSliderStyle(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag);
+        knobs[i].setTextBoxStyle(juce::Slider::TextBoxBelow, true, 50, 20);
+        addAndMakeVisible(knobs[i]);
+        knobAttachments[i] = std::make_unique<SliderAttachment>(apvts, knobIds[i], knobs[i]);
+        knobLabels[i].setText(knobNames[i], juce::dontSendNotification);
+        knobLabels[i].setJustificationType(juce::Justification::centred);
+        addAndMakeVisible(knobLabels[i]);
+    }
+}
+
+GrainComponent::~GrainComponent()
+{
+}
+
+void GrainComponent::paint (juce::Graphics& g)
+{
+    g.fillAll(juce::Colours::black);
+}
+
+void GrainComponent::resized()
+{
+    auto bounds = getLocalBounds().reduced(5);
+    engineSelector.setBounds(bounds.removeFromTop(30).reduced(0, 2));
+
+    const auto knobWidth = bounds.getWidth() / int(knobs.size());
+    for (size_t i = 0; i < knobs.size(); ++i) {
+        auto cell = bounds.removeFromLeft(knobWidth);
+        knobLabels[i].setBounds(cell.removeFromTop(20));
+        knobs[i].setBounds(cell);
+    }
+}
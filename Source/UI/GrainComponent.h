@@ -0,0 +1,40 @@
+/*
+  ==============================================================================
+
+    GrainComponent.h
+    Created: 27 Oct 2026 5:06:51pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+*/
+class GrainComponent  : public juce::Component
+{
+public:
+    GrainComponent(juce::AudioProcessorValueTreeState& apvts);
+    ~GrainComponent() override;
+
+    void paint (juce::Graphics&) override;
+    void resized() override;
+
+private:
+    using ComboBoxAttachment = juce::AudioProcessorValueTreeState::ComboBoxAttachment;
+    using SliderAttachment = juce::AudioProcessorValueTreeState::SliderAttachment;
+
+    juce::ComboBox engineSelector;
+    std::unique_ptr<ComboBoxAttachment> engineAttachment;
+
+    // Grain size, density, pitch jitter and stereo spread
+    std::array<juce::Slider, 4> knobs;
+    std::array<juce::Label, 4> knobLabels;
+    std::array<std::unique_ptr<SliderAttachment>, 4> knobAttachments;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GrainComponent)
+};
@@ -0,0 +1,80 @@
+/*
+  ==============================================================================
+
+    ModMatrixComponent.cpp
+    Created: 21 Oct 2026 5:12:40pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "ModMatrixComponent.h"
+
+//==============================================================================
+ModMatrixComponent::ModMatrixComponent(juce::AudioProcessorValueTreeState& apvts)
+{
+    for (int slot = 0; slot < ModMatrixData::num_slots; ++slot) {
+        auto& row = rows[slot];
+        const juce::String prefix = "MOD" + juce::String(slot + 1);
+
+        row.source.addItemList(ModMatrixData::source_names, 1);
+        row.dest.addItemList(ModMatrixData::dest_names, 1);
+        addAndMakeVisible(row.source);
+        addAndMakeVisible(row.dest);
+        setSliderParams(row.amount, juce::Slider::SliderStyle::LinearHorizontal);
+
+        row.sourceAttachment = std::make_unique<ComboBoxAttachment>(apvts, prefix + "SOURCE", row.source);
+        row.destAttachment = std::make_unique<ComboBoxAttachment>(apvts, prefix + "DEST", row.dest);
+        row.amountAttachment = std::make_unique<SliderAttachment>(apvts, prefix + "AMOUNT", row.amount);
+    }
+
+    const char* const knobIds[] = { "LFO1RATE", "LFO2RATE", "MODATTACK", "MODDECAY", "MODSUSTAIN", "MODRELEASE" };
+    const char* const knobNames[] = { "LFO 1", "LFO 2", "A", "D", "S", "R" };
+    for (size_t i = 0; i < knobs.size(); ++i) {
+        setSliderParams(knobs[i], juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag);
+        knobAttachments[i] = std::make_unique<SliderAttachment>(apvts, knobIds[i], knobs[i]);
+        knobLabels[i].setText(knobNames[i], juce::dontSendNotification);
+        knobLabels[i].setJustificationType(juce::Justification::centred);
+        addAndMakeVisible(knobLabels[i]);
+    }
+}
+
+ModMatrixComponent::~ModMatrixComponent()
+{
+}
+
+void ModMatrixComponent::paint (juce::Graphics& g)
+{
+    g.fillAll(juce::Colours::black);
+}
+
+void ModMatrixComponent::resized()
+{
+    auto bounds = getLocalBounds().reduced(5);
+
+    for (auto& row : rows) {
+        auto line = bounds.removeFromTop(30);
+        row.source.setBounds(line.removeFromLeft(line.getWidth() / 2).reduced(2));
+        row.dest.setBounds(line.reduced(2));
+        row.amount.setBounds(bounds.removeFromTop(30));
+        bounds.removeFromTop(5);
+    }
+
+    // Two rows of three knobs
+    const auto knobWidth = bounds.getWidth() / 3;
+    for (int r = 0; r < 2; ++r) {
+        auto line = bounds.removeFromTop(juce::jmin(100, bounds.getHeight() / (2 - r)));
+        for (int k = 0; k < 3; ++k) {
+            auto cell = line.removeFromLeft(knobWidth);
+            knobLabels[r * 3 + k].setBounds(cell.removeFromTop(20));
+            knobs[r * 3 + k].setBounds(cell);
+        }
+    }
+}
+
+void ModMatrixComponent::setSliderParams(juce::Slider& slider, juce::Slider::SliderStyle style) {
+    slider.setSliderStyle(style);
+    slider.setTextBoxStyle(juce::Slider::TextBoxBelow, true, 50, 20);
+    addAndMakeVisible(slider);
+}
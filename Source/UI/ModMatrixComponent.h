@@ -0,0 +1,50 @@
+/*
+  ==============================================================================
+
+    ModMatrixComponent.h
+    Created: 21 Oct 2026 5:12:40pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../Data/ModMatrixData.h"
+
+//==============================================================================
+/*
+*/
+class ModMatrixComponent  : public juce::Component
+{
+public:
+    ModMatrixComponent(juce::AudioProcessorValueTreeState& apvts);
+    ~ModMatrixComponent() override;
+
+    void paint (juce::Graphics&) override;
+    void resized() override;
+
+private:
+    void setSliderParams(juce::Slider& slider, juce::Slider::SliderStyle style);
+
+    using ComboBoxAttachment = juce::AudioProcessorValueTreeState::ComboBoxAttachment;
+    using SliderAttachment = juce::AudioProcessorValueTreeState::SliderAttachment;
+
+    struct SlotRow {
+        juce::ComboBox source;
+        juce::ComboBox dest;
+        juce::Slider amount;
+        std::unique_ptr<ComboBoxAttachment> sourceAttachment;
+        std::unique_ptr<ComboBoxAttachment> destAttachment;
+        std::unique_ptr<SliderAttachment> amountAttachment;
+    };
+    std::array<SlotRow, ModMatrixData::num_slots> rows;
+
+    // LFO 1 and 2 rates, then the mod envelope's attack, decay, sustain and release
+    std::array<juce::Slider, 6> knobs;
+    std::array<juce::Label, 6> knobLabels;
+    std::array<std::unique_ptr<SliderAttachment>, 6> knobAttachments;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ModMatrixComponent)
+};
@@ -0,0 +1,186 @@
+/*
+  ==============================================================================
+
+    OrbitTrailRenderer.cpp
+    Created: 19 Oct 2026 2:10:38pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#include "OrbitTrailRenderer.h"
+
+using namespace juce::gl;
+
+void OrbitTrailRenderer::contextCreated(int numSlots)
+{
+    slots.assign(numSlots, Slot());
+    firsts.reserve(2 * numSlots);
+    counts.reserve(2 * numSlots);
+
+    const auto size = (GLsizeiptr)(sizeof(Vertex) * slot_stride * numSlots);
+
+    glGenBuffers(1, &vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+
+    if (juce::OpenGLHelpers::isExtensionSupported("GL_ARB_buffer_storage")) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags);
+        mapped = static_cast<Vertex*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags));
+
+        if (mapped == nullptr) {
+            // Storage is immutable once allocated, start over with a regular buffer
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            glDeleteBuffers(1, &vbo);
+            glGenBuffers(1, &vbo);
+            glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        }
+    }
+
+    if (mapped == nullptr) {
+        glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW);
+        staging.resize((size_t)slot_stride * numSlots);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void OrbitTrailRenderer::release()
+{
+    if (fence != nullptr) {
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+    if (mapped != nullptr) {
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        mapped = nullptr;
+    }
+    if (vbo != 0) {
+        glDeleteBuffers(1, &vbo);
+        vbo = 0;
+    }
+    slots.clear();
+    staging.clear();
+}
+
+void OrbitTrailRenderer::beginFrame()
+{
+    if (fence != nullptr) {
+        glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+}
+
+void OrbitTrailRenderer::restart(int slot)
+{
+    slots[slot].head = 0;
+    slots[slot].count = 0;
+}
+
+void OrbitTrailRenderer::push(int slot, const Vertex& vertex)
+{
+    auto& s = slots[slot];
+    Vertex* ring = (mapped != nullptr ? mapped : staging.data()) + slot * slot_stride;
+    ring[s.head] = vertex;
+    if (s.head == 0) {
+        ring[slot_points] = vertex;
+    }
+
+    if (++s.head == slot_points) {
+        s.head = 0;
+    }
+    s.count = juce::jmin(s.count + 1, slot_points);
+    s.dirty = true;
+}
+
+void OrbitTrailRenderer::draw()
+{
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+
+    firsts.clear();
+    counts.clear();
+    for (int i = 0; i < (int)slots.size(); ++i) {
+        auto& s = slots[i];
+        const int base = i * slot_stride;
+
+        if (mapped == nullptr && s.dirty) {
+            // The spare is only written once the ring has wrapped
+            const int written = (s.count == slot_points ? slot_stride : s.count);
+            glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)(sizeof(Vertex) * base), (GLsizeiptr)(sizeof(Vertex) * written), staging.data() + base);
+        }
+        s.dirty = false;
+
+        if (s.count < 2) {
+            continue;
+        }
+        if (s.count < slot_points) {
+            firsts.push_back(base);
+            counts.push_back(s.count);
+        }
+        else {
+            // Full ring: the oldest point is at the head. Unless the ring is
+            // exactly in order, the first strip runs on into the spare, which
+            // joins it to point 0 where the second one starts.
+            firsts.push_back(base + s.head);
+            counts.push_back(slot_points - s.head + (s.head > 0 ? 1 : 0));
+            if (s.head > 1) {
+                firsts.push_back(base);
+                counts.push_back(s.head);
+            }
+        }
+    }
+
+    if (!firsts.empty()) {
+        glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), nullptr);
+        glEnableVertexAttribArray(0);
+        glMultiDrawArrays(GL_LINE_STRIP, firsts.data(), counts.data(), (GLsizei)firsts.size());
+        glDisableVertexAttribArray(0);
+
+        if (mapped != nullptr) {
+            fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+const char* OrbitTrailRenderer::getVertexShader()
+{
+    return R"(
+            #version 400 compatibility
+            layout(location = 0) in vec4 aPoint;
+
+            uniform vec2 iResolution;
+            uniform vec2 iCam;
+            uniform float iZoom;
+            uniform float iNow;
+            uniform float iFade;
+
+            out vec4 vColour;
+
+            void main() {
+                //Same transform as PtToScreen, in clip space
+                vec2 screen = iZoom * (aPoint.xy + iCam) / (iResolution * 0.5);
+                gl_Position = vec4(screen.x, -screen.y, 0.0, 1.0);
+
+                float age = clamp((iNow - aPoint.z) / iFade, 0.0, 1.0);
+                vec3 hue = cos(6.2831853 * (aPoint.w * 0.137 + vec3(0.0, 0.33, 0.67))) * 0.5 + 0.5;
+                vColour = vec4(aPoint.w < 0.0 ? vec3(1.0, 0.0, 0.0) : hue, 1.0 - age);
+            }
+        )";
+}
+
+const char* OrbitTrailRenderer::getFragmentShader()
+{
+    return R"(
+            #version 400 compatibility
+            in vec4 vColour;
+
+            void main() {
+                gl_FragColor = vColour;
+            }
+        )";
+}
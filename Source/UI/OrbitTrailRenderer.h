@@ -0,0 +1,64 @@
+/*
+  ==============================================================================
+
+    OrbitTrailRenderer.h
+    Created: 19 Oct 2026 2:10:38pm
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Draws fading orbit trails from a ring vertex buffer. Every trail owns a fixed
+// slot of the buffer, new points overwrite the oldest ones, and all trails are
+// drawn with a single glMultiDrawArrays call. Points are kept in fractal
+// coordinates; the camera transform and the fade are done in the vertex shader.
+// When ARB_buffer_storage is available the buffer stays persistently mapped and
+// points are written straight into it.
+class OrbitTrailRenderer {
+public:
+    struct Vertex {
+        float x;
+        float y;
+        float stamp; // Time the point was produced, in seconds
+        float trail; // Trail index, drives the colour; negative for the preview orbit
+    };
+
+    static const int slot_points = 2048;
+    // Every slot has one spare vertex after its ring, a copy of point 0, so a
+    // wrapped trail is drawn across the join
+    static const int slot_stride = slot_points + 1;
+
+    void contextCreated(int numSlots);
+    void release();
+
+    // Waits until the GPU is done with the previous frame's draw, so its points can be overwritten.
+    void beginFrame();
+
+    void restart(int slot);
+    void push(int slot, const Vertex& vertex);
+
+    // Binds the buffer to attribute 0 and draws every trail.
+    void draw();
+
+    static const char* getVertexShader();
+    static const char* getFragmentShader();
+private:
+    struct Slot {
+        int head = 0;
+        int count = 0;
+        bool dirty = false;
+    };
+
+    std::vector<Slot> slots;
+    std::vector<Vertex> staging;
+    std::vector<GLint> firsts;
+    std::vector<GLsizei> counts;
+
+    GLuint vbo = 0;
+    Vertex* mapped = nullptr;
+    GLsync fence = nullptr;
+};
@@ -14,9 +14,10 @@
 //==============================================================================
 OscComponent::OscComponent(juce::AudioProcessorValueTreeState& apvts, juce::String waveSelectorId)
 {
-    juce::StringArray choices { "Mandelbrot", "Burning ship", "Feather", "SFX", "Henon", "Duffing", "Ikeda", "Chirikov" };
-
-    oscWaveSelector.addItemList(choices, 1);
+    // The parameter's own list, which ends with the custom formula type
+    if (auto* choice = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter(waveSelectorId))) {
+        oscWaveSelector.addItemList(choice->choices, 1);
+    }
 
     addAndMakeVisible(oscWaveSelector);
 
@@ -0,0 +1,231 @@
+/*
+  ==============================================================================
+
+    ShaderProgramCache.cpp
+    Created: 19 Oct 2026 11:20:54am
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#include "ShaderProgramCache.h"
+
+using namespace juce::gl;
+
+static const int binary_magic = 0x42535850; // "PXSB"
+static const GLenum completion_status_khr = 0x91B1;
+
+static GLuint compileShader(GLenum type, const juce::String& source) {
+    GLuint shader = glCreateShader(type);
+    const GLchar* text = source.toRawUTF8();
+    glShaderSource(shader, 1, &text, nullptr);
+    glCompileShader(shader);
+    return shader;
+}
+
+static void logShaderErrors(GLuint shader) {
+    GLint compiled = 0;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+    if (compiled == GL_TRUE) {
+        return;
+    }
+    GLchar log[2048] = {};
+    glGetShaderInfoLog(shader, sizeof(log) - 1, nullptr, log);
+    DBG("Shader compile error: " << log);
+}
+
+//==============================================================================
+ShaderProgramCache::ShaderProgramCache()
+{
+    cacheDirectory = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("Phractal")
+        .getChildFile("ShaderCache");
+}
+
+void ShaderProgramCache::contextCreated()
+{
+    // Binaries are only valid for the driver that produced them
+    driverId = juce::String((const char*)glGetString(GL_VENDOR))
+        + juce::String((const char*)glGetString(GL_RENDERER))
+        + juce::String((const char*)glGetString(GL_VERSION));
+
+    GLint numFormats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+    binarySupported = (numFormats > 0);
+
+    parallelCompile = juce::OpenGLHelpers::isExtensionSupported("GL_KHR_parallel_shader_compile")
+        || juce::OpenGLHelpers::isExtensionSupported("GL_ARB_parallel_shader_compile");
+}
+
+void ShaderProgramCache::release()
+{
+    for (auto& entry : programs) {
+        deleteProgram(entry.second);
+    }
+    programs.clear();
+}
+
+void ShaderProgramCache::removeIf(const std::function<bool(int key)>& shouldRemove)
+{
+    for (auto it = programs.begin(); it != programs.end();) {
+        if (shouldRemove(it->first)) {
+            deleteProgram(it->second);
+            it = programs.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
+void ShaderProgramCache::deleteProgram(Program& program)
+{
+    if (program.vertex != 0) {
+        glDeleteShader(program.vertex);
+    }
+    if (program.fragment != 0) {
+        glDeleteShader(program.fragment);
+    }
+    if (program.id != 0) {
+        glDeleteProgram(program.id);
+    }
+}
+
+GLuint ShaderProgramCache::getProgram(int key, const juce::String& vertexSource, const std::function<juce::String()>& makeFragmentSource)
+{
+    auto it = programs.find(key);
+    if (it == programs.end()) {
+        const auto fragmentSource = makeFragmentSource();
+        const auto hash = (vertexSource + fragmentSource + driverId).hashCode64();
+
+        it = programs.emplace(key, Program()).first;
+        auto& program = it->second;
+        program.binaryFile = cacheDirectory.getChildFile(juce::String::toHexString(hash) + ".bin");
+
+        if (!loadBinary(program)) {
+            startCompile(program, vertexSource, fragmentSource);
+        }
+    }
+
+    auto& program = it->second;
+    if (program.linking) {
+        finishCompile(program);
+    }
+    return program.ready ? program.id : 0;
+}
+
+void ShaderProgramCache::startCompile(Program& program, const juce::String& vertexSource, const juce::String& fragmentSource)
+{
+    program.vertex = compileShader(GL_VERTEX_SHADER, vertexSource);
+    program.fragment = compileShader(GL_FRAGMENT_SHADER, fragmentSource);
+
+    program.id = glCreateProgram();
+    glAttachShader(program.id, program.vertex);
+    glAttachShader(program.id, program.fragment);
+    if (binarySupported) {
+        glProgramParameteri(program.id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+    // With parallel compile this returns immediately and the driver links in the background
+    glLinkProgram(program.id);
+    program.linking = true;
+}
+
+void ShaderProgramCache::finishCompile(Program& program)
+{
+    if (parallelCompile) {
+        GLint done = GL_FALSE;
+        glGetProgramiv(program.id, completion_status_khr, &done);
+        if (done == GL_FALSE) {
+            return;
+        }
+    }
+    program.linking = false;
+
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program.id, GL_LINK_STATUS, &linked);
+    if (linked == GL_FALSE) {
+        // Oops - something went wrong with our shaders!
+        // Check the output window of your IDE to see what the error might be.
+        logShaderErrors(program.vertex);
+        logShaderErrors(program.fragment);
+        jassertfalse;
+    }
+
+    glDetachShader(program.id, program.vertex);
+    glDetachShader(program.id, program.fragment);
+    glDeleteShader(program.vertex);
+    glDeleteShader(program.fragment);
+    program.vertex = program.fragment = 0;
+
+    if (linked == GL_FALSE) {
+        // Keep the failed entry so it isn't recompiled every frame
+        glDeleteProgram(program.id);
+        program.id = 0;
+        return;
+    }
+
+    program.ready = true;
+    saveBinary(program);
+}
+
+bool ShaderProgramCache::loadBinary(Program& program)
+{
+    if (!binarySupported || !program.binaryFile.existsAsFile()) {
+        return false;
+    }
+
+    juce::MemoryBlock data;
+    if (!program.binaryFile.loadFileAsData(data) || data.getSize() <= 2 * sizeof(int)) {
+        return false;
+    }
+
+    juce::MemoryInputStream in(data, false);
+    if (in.readInt() != binary_magic) {
+        return false;
+    }
+    const GLenum format = (GLenum)in.readInt();
+    const auto offset = (size_t)in.getPosition();
+
+    program.id = glCreateProgram();
+    glProgramBinary(program.id, format, static_cast<const char*>(data.getData()) + offset, (GLsizei)(data.getSize() - offset));
+
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program.id, GL_LINK_STATUS, &linked);
+    if (linked == GL_FALSE) {
+        // Stale binary (e.g. the driver was updated), rebuild it from source
+        glDeleteProgram(program.id);
+        program.id = 0;
+        program.binaryFile.deleteFile();
+        return false;
+    }
+
+    program.ready = true;
+    return true;
+}
+
+void ShaderProgramCache::saveBinary(const Program& program)
+{
+    if (!binarySupported) {
+        return;
+    }
+
+    GLint length = 0;
+    glGetProgramiv(program.id, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+
+    juce::HeapBlock<char> blob((size_t)length);
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(program.id, length, &written, &format, blob.get());
+
+    juce::MemoryOutputStream out;
+    out.writeInt(binary_magic);
+    out.writeInt((int)format);
+    out.write(blob.get(), (size_t)written);
+
+    if (cacheDirectory.createDirectory().wasOk()) {
+        program.binaryFile.replaceWithData(out.getData(), out.getDataSize());
+    }
+}
@@ -0,0 +1,60 @@
+/*
+  ==============================================================================
+
+    ShaderProgramCache.h
+    Created: 19 Oct 2026 11:20:54am
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Lazily builds GL programs keyed by an integer variant id, and keeps their
+// glGetProgramBinary blobs on disk so the next session can skip compilation.
+// All methods must be called on the thread that owns the GL context.
+class ShaderProgramCache {
+public:
+    ShaderProgramCache();
+
+    void contextCreated();
+    void release();
+
+    // Returns the linked program for key, or 0 while it is still being loaded or
+    // compiled. The first call for a key loads its cached binary or starts a
+    // compile from the sources returned by makeFragmentSource.
+    GLuint getProgram(int key, const juce::String& vertexSource, const std::function<juce::String()>& makeFragmentSource);
+
+    bool contains(int key) const { return programs.find(key) != programs.end(); }
+
+    // Deletes the programs whose key matches, for variants that can't be asked for again
+    void removeIf(const std::function<bool(int key)>& shouldRemove);
+
+    // True if the driver compiles in the background (GL_KHR_parallel_shader_compile),
+    // so warming other variants doesn't stall the frame.
+    bool canCompileInBackground() const { return parallelCompile; }
+
+private:
+    struct Program {
+        GLuint id = 0;
+        GLuint vertex = 0;
+        GLuint fragment = 0;
+        bool linking = false;
+        bool ready = false;
+        juce::File binaryFile;
+    };
+
+    static void deleteProgram(Program& program);
+    void startCompile(Program& program, const juce::String& vertexSource, const juce::String& fragmentSource);
+    void finishCompile(Program& program);
+    bool loadBinary(Program& program);
+    void saveBinary(const Program& program);
+
+    std::map<int, Program> programs;
+    juce::File cacheDirectory;
+    juce::String driverId;
+    bool parallelCompile = false;
+    bool binarySupported = false;
+};
@@ -0,0 +1,139 @@
+/*
+  ==============================================================================
+
+    SpectrumScopeComponent.cpp
+    Created: 26 Oct 2026 9:52:44am
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "SpectrumScopeComponent.h"
+
+//==============================================================================
+SpectrumScopeComponent::SpectrumScopeComponent(PhractalAudioProcessor& pap)
+    : audioProcessor(pap), popLeft(AudioTapFifo::capacity), popRight(AudioTapFifo::capacity)
+{
+    spectrum.fill(min_db);
+    setOpaque(true);
+    startTimerHz(display_hz);
+}
+
+SpectrumScopeComponent::~SpectrumScopeComponent()
+{
+    stopTimer();
+    audioProcessor.getAudioTap().setEnabled(false);
+}
+
+void SpectrumScopeComponent::timerCallback()
+{
+    // Hidden, minimised or on a closed editor tab: no copies on the audio thread, no FFTs here
+    auto& tap = audioProcessor.getAudioTap();
+    if (!isShowing()) {
+        tap.setEnabled(false);
+        return;
+    }
+    tap.setEnabled(true);
+
+    const int count = tap.pop(popLeft.data(), popRight.data(), AudioTapFifo::capacity);
+    if (count == 0) {
+        return;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        const float l = popLeft[size_t(i)];
+        const float r = popRight[size_t(i)];
+        history[size_t(historyPos)] = 0.5f * (l + r);
+        historyPos = (historyPos + 1) % fft_size;
+        scopeX[size_t(scopePos)] = l;
+        scopeY[size_t(scopePos)] = r;
+        scopePos = (scopePos + 1) % scope_points;
+
+        if (++samplesSinceFft == hop_size) {
+            samplesSinceFft = 0;
+            runFft();
+        }
+    }
+    repaint();
+}
+
+void SpectrumScopeComponent::runFft()
+{
+    // Oldest sample first
+    std::copy(history.begin() + historyPos, history.end(), fftData.begin());
+    std::copy(history.begin(), history.begin() + historyPos, fftData.begin() + (fft_size - historyPos));
+    std::fill(fftData.begin() + fft_size, fftData.end(), 0.0f);
+
+    window.multiplyWithWindowingTable(fftData.data(), size_t(fft_size));
+    fft.performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+    // A full scale sine reads 0 dB: the Hann window halves the amplitude
+    const float scale = 4.0f / float(fft_size);
+    for (size_t k = 0; k < spectrum.size(); ++k) {
+        const float db = juce::Decibels::gainToDecibels(fftData[k] * scale, min_db);
+        spectrum[k] = juce::jmax(db, spectrum[k] - fall_db);
+    }
+}
+
+void SpectrumScopeComponent::paint (juce::Graphics& g)
+{
+    g.fillAll(juce::Colours::black);
+
+    // Spectrum on a log frequency axis from 20 Hz to Nyquist
+    const double sampleRate = audioProcessor.getSampleRate() > 0.0 ? audioProcessor.getSampleRate() : double(sample_rate);
+    const float nyquist = float(sampleRate * 0.5);
+    const float logMin = std::log(20.0f);
+    const float logRange = std::log(nyquist) - logMin;
+    const auto area = spectrumArea.toFloat();
+
+    juce::Path path;
+    bool started = false;
+    for (size_t k = 1; k < spectrum.size(); ++k) {
+        const float freq = float(k) * float(sampleRate) / float(fft_size);
+        if (freq < 20.0f) {
+            continue;
+        }
+        const float x = area.getX() + area.getWidth() * (std::log(freq) - logMin) / logRange;
+        const float y = area.getY() + area.getHeight() * (spectrum[k] / min_db);
+        if (!started) {
+            path.startNewSubPath(x, y);
+            started = true;
+        }
+        else {
+            path.lineTo(x, y);
+        }
+    }
+    g.setColour(juce::Colours::darkgrey);
+    g.drawRect(spectrumArea);
+    g.setColour(juce::Colours::orange);
+    g.strokePath(path, juce::PathStrokeType(1.0f));
+
+    // XY scope, oldest point first
+    const auto scope = scopeArea.toFloat();
+    const float half = scope.getWidth() * 0.5f;
+    juce::Path trace;
+    for (int i = 0; i < scope_points; ++i) {
+        const int j = (scopePos + i) % scope_points;
+        const float x = scope.getCentreX() + juce::jlimit(-1.0f, 1.0f, scopeX[size_t(j)]) * half;
+        const float y = scope.getCentreY() - juce::jlimit(-1.0f, 1.0f, scopeY[size_t(j)]) * half;
+        if (i == 0) {
+            trace.startNewSubPath(x, y);
+        }
+        else {
+            trace.lineTo(x, y);
+        }
+    }
+    g.setColour(juce::Colours::darkgrey);
+    g.drawRect(scopeArea);
+    g.setColour(juce::Colours::lightgreen.withAlpha(0.7f));
+    g.strokePath(trace, juce::PathStrokeType(1.0f));
+}
+
+void SpectrumScopeComponent::resized()
+{
+    auto bounds = getLocalBounds().reduced(5);
+    scopeArea = bounds.removeFromRight(bounds.getHeight());
+    bounds.removeFromRight(5);
+    spectrumArea = bounds;
+}
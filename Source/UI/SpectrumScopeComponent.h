@@ -0,0 +1,66 @@
+/*
+  ==============================================================================
+
+    SpectrumScopeComponent.h
+    Created: 26 Oct 2026 9:52:44am
+    Author:  tri99er
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../PluginProcessor.h"
+
+//==============================================================================
+/*
+    Spectrum of the output and a stereo XY scope of it (left is x, right is y, so
+    the orbit's own shape shows up), fed by the processor's audio tap at display
+    rate. The spectrum is a Hann-windowed FFT every quarter frame, with falling
+    peaks. While the component isn't on screen the tap is switched off and
+    nothing is analysed.
+*/
+class SpectrumScopeComponent  : public juce::Component, private juce::Timer
+{
+public:
+    SpectrumScopeComponent(PhractalAudioProcessor& pap);
+    ~SpectrumScopeComponent() override;
+
+    void paint (juce::Graphics&) override;
+    void resized() override;
+
+    static const int fft_order = 11;
+    static const int fft_size = 1 << fft_order;
+    static const int hop_size = fft_size / 4;
+    static const int scope_points = 1024;
+    static const int display_hz = 30;
+    static constexpr float min_db = -90.0f;
+    // How far the peaks fall per FFT
+    static constexpr float fall_db = 1.0f;
+private:
+    void timerCallback() override;
+    void runFft();
+
+    PhractalAudioProcessor& audioProcessor;
+
+    juce::dsp::FFT fft { fft_order };
+    juce::dsp::WindowingFunction<float> window { size_t(fft_size), juce::dsp::WindowingFunction<float>::hann, false };
+    std::array<float, fft_size> history {};
+    int historyPos = 0;
+    int samplesSinceFft = 0;
+    std::array<float, 2 * fft_size> fftData {};
+    std::array<float, fft_size / 2> spectrum;
+
+    std::array<float, scope_points> scopeX {};
+    std::array<float, scope_points> scopeY {};
+    int scopePos = 0;
+
+    std::vector<float> popLeft;
+    std::vector<float> popRight;
+
+    juce::Rectangle<int> spectrumArea;
+    juce::Rectangle<int> scopeArea;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectrumScopeComponent)
+};